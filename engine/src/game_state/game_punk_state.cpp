@@ -136,12 +136,7 @@ namespace internal
         static f32 plot_data[data_count] = { 0 };
         static u8 data_offset = 0;
 
-        int active_count = 0;
-        for (u32 i = 0; i < N; i++)
-        {
-            game::TileID id = { i };
-            active_count += game::is_spawned(table, id);
-        }
+        int active_count = (int)table.size();
 
         plot_data[data_offset++] = (f32)active_count;
 
@@ -161,15 +156,11 @@ namespace internal
 
     static void tile_table(game::TileTable const& table)
     {
-        static bool show_inactive = true;
-
-        ImGui::Checkbox("Show Inactive", &show_inactive);
-
         constexpr int col_id = 0;
         constexpr int col_pos = col_id + 1;
         constexpr int col_bmp = col_pos + 1;
-        constexpr int col_active = col_bmp + 1;
-        constexpr int n_columns = col_active + 1;
+        constexpr int col_gen = col_bmp + 1;
+        constexpr int n_columns = col_gen + 1;
 
         int table_flags = ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_BordersInnerV;
         auto table_dims = ImVec2(0.0f, 0.0f);
@@ -182,9 +173,9 @@ namespace internal
         ImGui::TableSetupColumn("Id", ImGuiTableColumnFlags_WidthFixed, 20.0f);
         ImGui::TableSetupColumn("Pos", ImGuiTableColumnFlags_WidthStretch, 20.0f);
         ImGui::TableSetupColumn("Bmp", ImGuiTableColumnFlags_WidthStretch, 20.0f);
-        ImGui::TableSetupColumn("On", ImGuiTableColumnFlags_WidthStretch, 20.0f);
+        ImGui::TableSetupColumn("Gen", ImGuiTableColumnFlags_WidthStretch, 20.0f);
 
-        auto N = table.capacity;
+        auto N = table.size();
         auto pos = table.position;
         auto bmp = table.bitmap_id;
 
@@ -192,16 +183,12 @@ namespace internal
 
         for (u32 i = 0; i < N; i++)
         {
-            game::TileID id = { i };
-            if (!show_inactive && !game::is_spawned(table, id))
-            {
-                continue;
-            }
+            auto id = table.id_at(i);
 
             ImGui::TableNextRow();
 
             ImGui::TableSetColumnIndex(col_id);
-            ImGui::Text("%u", i);
+            ImGui::Text("%u", id.value_);
 
             ImGui::TableSetColumnIndex(col_pos);
             ImGui::Text("(%4.0f, %4.0f)", pos[i].x.get(), pos[i].y.get());
@@ -209,8 +196,8 @@ namespace internal
             ImGui::TableSetColumnIndex(col_bmp);
             ImGui::Text("%u", bmp[i].value_);
 
-            ImGui::TableSetColumnIndex(col_active);
-            ImGui::Text("%d", game::is_spawned(table, id));
+            ImGui::TableSetColumnIndex(col_gen);
+            ImGui::Text("%u", id.generation_);
         }
 
         ImGui::EndTable();
@@ -236,15 +223,11 @@ namespace internal
 
     static void sprite_table(game::SpriteTable const& table)
     {
-        static bool show_inactive = true;
-
-        ImGui::Checkbox("Show Inactive", &show_inactive);
-
         constexpr int col_id = 0;
         constexpr int col_pos = col_id + 1;
         constexpr int col_vel = col_pos + 1;
-        constexpr int col_active = col_vel + 1;
-        constexpr int n_columns = col_active + 1;
+        constexpr int col_gen = col_vel + 1;
+        constexpr int n_columns = col_gen + 1;
 
         int table_flags = ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_BordersInnerV;
         auto table_dims = ImVec2(0.0f, 0.0f);
@@ -257,27 +240,23 @@ namespace internal
         ImGui::TableSetupColumn("Id", ImGuiTableColumnFlags_WidthFixed, 20.0f);
         ImGui::TableSetupColumn("Pos", ImGuiTableColumnFlags_WidthStretch, 20.0f);
         ImGui::TableSetupColumn("Vel", ImGuiTableColumnFlags_WidthStretch, 20.0f);
-        ImGui::TableSetupColumn("On", ImGuiTableColumnFlags_WidthStretch, 20.0f);
+        ImGui::TableSetupColumn("Gen", ImGuiTableColumnFlags_WidthStretch, 20.0f);
 
-        auto N = table.capacity;
+        auto N = table.size();
 
         ImGui::TableHeadersRow();
 
         for (u32 i = 0; i < N; i++)
         {
-            game::SpriteID id = { i };
+            auto id = table.id_at(i);
 
-            if (!show_inactive && !game::is_spawned(table, id))
-            {
-                continue;
-            }
             auto pos = table.get_tile_pos(id);
             auto vel = table.get_tile_velocity(id);
 
             ImGui::TableNextRow();
 
             ImGui::TableSetColumnIndex(col_id);
-            ImGui::Text("%u", i);
+            ImGui::Text("%u", id.value_);
 
             ImGui::TableSetColumnIndex(col_pos);
             ImGui::Text("(%4.0f, %4.0f)", pos.x.get(), pos.y.get());
@@ -285,8 +264,8 @@ namespace internal
             ImGui::TableSetColumnIndex(col_vel);
             ImGui::Text("(%4.3f, %4.3f)", vel.x.get(), vel.y.get());
 
-            ImGui::TableSetColumnIndex(col_active);
-            ImGui::Text("%d", game::is_spawned(table, id));
+            ImGui::TableSetColumnIndex(col_gen);
+            ImGui::Text("%u", id.generation_);
         }
 
         ImGui::EndTable();
@@ -313,12 +292,7 @@ namespace internal
         static f32 plot_data[data_count] = { 0 };
         static u8 data_offset = 0;
 
-        int active_count = 0;
-        for (u32 i = 0; i < N; i++)
-        {
-            game::SpriteID id = { i };
-            active_count += game::is_spawned(table, id);
-        }
+        int active_count = (int)table.size();
 
         plot_data[data_offset++] = (f32)active_count;
 
@@ -353,6 +327,99 @@ namespace internal
 }
 }
 
+/* memory */
+
+namespace game_state
+{
+namespace internal
+{
+    static void memory(game::Memory const& mem)
+    {
+        ImGui::SeparatorText("Memory");
+
+        auto scratch = mem.capacity - mem.scratch_begin;
+
+        ImGui::Text("Arena:   %u / %u", mem.size, mem.scratch_begin);
+        ImGui::Text("Scratch: %u / %u", mem.scratch_size, scratch);
+        ImGui::Text("High:    %u", mem.scratch_high);
+    }
+}
+}
+
+
+/* determinism */
+
+namespace game_state
+{
+namespace internal
+{
+    static void hashes(game::DebugContext& dbg)
+    {
+        auto& hash = dbg.hash;
+
+        ImGui::SeparatorText("Hash");
+
+        ImGui::Text("Tick:   %llu", (unsigned long long)hash.tick);
+        ImGui::Text("State:  %016llx", (unsigned long long)hash.state);
+
+        bool screen_on = hash.screen_on;
+        ImGui::Checkbox("Screen##HashScreenOn", &screen_on);
+        hash.screen_on = screen_on;
+
+        if (hash.screen_on)
+        {
+            ImGui::SameLine();
+            ImGui::Text("%016llx", (unsigned long long)hash.screen);
+        }
+
+        // state hash of the last frames, divergence shows the tick
+        auto N = dbg.HASH_HISTORY;
+
+        for (u32 i = 0; i < N; i++)
+        {
+            auto k = (hash.history_cursor + N - 1 - i) % N;
+            ImGui::Text("%8llu %016llx", (unsigned long long)hash.history_tick[k], (unsigned long long)hash.history_state[k]);
+        }
+    }
+}
+}
+
+
+/* profiler */
+
+namespace game_state
+{
+namespace internal
+{
+    static void profile_zones()
+    {
+        namespace prf = game::profile;
+
+        ImGui::SeparatorText("Last Frame");
+
+        for (u32 i = 0; i < prf::ZONE_COUNT; i++)
+        {
+            auto zone = (prf::ZoneId)i;
+            ImGui::Text("%-16s %7.3f ms", prf::ZONE_NAMES[i], prf::last_frame_ms(zone));
+        }
+
+        static bool dump_ok = true;
+
+        if (ImGui::Button("Dump Trace##BtnDumpTrace"))
+        {
+            dump_ok = prf::dump_trace("punk_run_trace.json");
+        }
+
+        if (!dump_ok)
+        {
+            ImGui::SameLine();
+            ImGui::Text("write failed");
+        }
+    }
+}
+}
+
+
 /* game state */
 
 namespace game_state
@@ -387,7 +454,22 @@ namespace game_state
         if (ImGui::CollapsingHeader("Sprites"))
         {
             internal::sprites(data.sprites);
-        }        
+        }
+
+        if (ImGui::CollapsingHeader("Memory"))
+        {
+            internal::memory(data.memory);
+        }
+
+        if (ImGui::CollapsingHeader("Hash"))
+        {
+            internal::hashes(game_dbg);
+        }
+
+        if (ImGui::CollapsingHeader("Profiler"))
+        {
+            internal::profile_zones();
+        }
 
         ImGui::End();
     }
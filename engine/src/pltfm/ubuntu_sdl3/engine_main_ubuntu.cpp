@@ -14,6 +14,7 @@
 #include "../../ui/ui.hpp"
 #include "../../game_state/game_state.hpp"
 #include "../../../../libs/datetime/datetime.hpp"
+#include "../../../../libs/io/input/input_record.hpp"
 
 
 namespace img = image;
@@ -51,6 +52,9 @@ namespace mv
     Stopwatch game_sw;
     EngineState state{};
 
+    input::InputRecorder recorder;
+    input::InputReplay replay;
+
     constexpr u32 N_TEXTURES = 2;
     ogl_imgui::TextureList<N_TEXTURES> textures;
 
@@ -147,6 +151,52 @@ static void process_user_input()
 }
 
 
+static void toggle_record()
+{
+    mv::state.cmd_toggle_record = 0;
+
+    if (input::is_recording(mv::recorder))
+    {
+        input::end_record(mv::recorder);
+    }
+    else if (input::begin_record(mv::recorder, INPUT_RECORD_PATH))
+    {
+        gs::reset();
+    }
+
+    mv::state.is_recording = input::is_recording(mv::recorder);
+}
+
+
+static void toggle_replay()
+{
+    mv::state.cmd_toggle_replay = 0;
+
+    if (input::is_replaying(mv::replay))
+    {
+        input::end_replay(mv::replay);
+    }
+    else if (input::begin_replay(mv::replay, INPUT_RECORD_PATH))
+    {
+        gs::reset();
+    }
+
+    mv::state.is_replaying = input::is_replaying(mv::replay);
+}
+
+
+static input::Input& next_game_input(input::Input& input)
+{
+    auto replay = input::is_replaying(mv::replay) && input::replay_input(mv::replay);
+    mv::state.is_replaying = replay;
+
+    auto& game_input = replay ? mv::replay.input : input;
+    input::record_frame(mv::recorder, game_input);
+
+    return game_input;
+}
+
+
 static void render_textures()
 {
     auto& io_test_texture = mv::textures.get_gl_texture_ref(mv::io_test_texture_id);
@@ -303,6 +353,9 @@ static bool main_init()
 
 static void main_close()
 {
+    input::end_record(mv::recorder);
+    input::end_replay(mv::replay);
+
     iot::close(mv::io_test_state);
 
     img::destroy_image(mv::io_test_screen);
@@ -332,9 +385,19 @@ static void main_loop_seq()
             mv::state.hard_pause = !mv::state.hard_pause;
         }
 
+        if (mv::state.cmd_toggle_record)
+        {
+            toggle_record();
+        }
+
+        if (mv::state.cmd_toggle_replay)
+        {
+            toggle_replay();
+        }
+
         if (!mv::state.hard_pause)
         {
-            game_state_update(input);
+            game_state_update(next_game_input(input));
         }
 
         if (mv::ui_state.cmd_end_program || input.cmd_end_program)
@@ -14,6 +14,8 @@ constexpr f64 TARGET_FRAMERATE_HZ = 60.0;
 constexpr f64 TARGET_NS_PER_FRAME = NANO / TARGET_FRAMERATE_HZ;
 constexpr f64 TARGET_MS_PER_FRAME = TARGET_NS_PER_FRAME / MICRO;
 
+constexpr auto INPUT_RECORD_PATH = "./punk_input.rec";
+
 
 class InputFrames
 {
@@ -103,6 +105,12 @@ public:
     b8 cmd_toggle_pause = 0;
     b8 cmd_reset_game = 0;
 
+    b8 is_recording = 0;
+    b8 is_replaying = 0;
+
+    b8 cmd_toggle_record = 0;
+    b8 cmd_toggle_replay = 0;
+
     b8 cmd_save_screenshot = 0;
 
     b8 iot_active = 0;
@@ -189,6 +197,20 @@ namespace ui
 
         ImGui::SameLine();
 
+        if (ImGui::Button(state.is_recording ? "Stop##RecordButton" : "Record##RecordButton"))
+        {
+            state.cmd_toggle_record = true;
+        }
+
+        ImGui::SameLine();
+
+        if (ImGui::Button(state.is_replaying ? "Stop##ReplayButton" : "Replay##ReplayButton"))
+        {
+            state.cmd_toggle_replay = true;
+        }
+
+        ImGui::SameLine();
+
         constexpr auto slider_scale_min = 0.5f;
         static f32 slider_scale_max = 10.0f;
 
@@ -18,6 +18,21 @@
 #define app_crash(message) assert(false && message)
 #endif
 
+#ifndef MATH_NO_SIMD
+
+#if defined(__AVX2__)
+#define BIN_TABLE_SIMD_256
+#include <immintrin.h>
+#elif defined(__wasm_simd128__)
+#define BIN_TABLE_SIMD_WASM_128
+#include <wasm_simd128.h>
+#elif defined(__SSE2__)
+#define BIN_TABLE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#endif // MATH_NO_SIMD
+
 /* types */
 
 namespace bin_table
@@ -52,6 +67,9 @@ namespace bin_table
 		Image1C_AlphaFilter,
 		Image1C_TableFilter,
 
+		Image1C_IndexRaw,    // 1 channel, uncompressed index plane
+		Image1C_IndexRLE,    // 1 channel, run-length encoded index plane
+
         Music,
         SFX
     };
@@ -116,6 +134,8 @@ namespace bin_table
 		case FileType::Image1C:
 		case FileType::Image1C_AlphaFilter:
 		case FileType::Image1C_TableFilter:
+		case FileType::Image1C_IndexRaw:
+		case FileType::Image1C_IndexRLE:
 			return sizeof(u8);
 
 		default:
@@ -179,6 +199,95 @@ namespace bin_table
     }
 
 
+	// index plane RLE control byte
+	// c <  RLE_RUN: c + 1 literal bytes follow
+	// c >= RLE_RUN: next byte repeats c - RLE_RUN + RLE_MIN_RUN times
+	constexpr u32 RLE_RUN = 128;
+	constexpr u32 RLE_MIN_RUN = 3;
+	constexpr u32 RLE_MAX_LITERAL = RLE_RUN;
+	constexpr u32 RLE_MAX_RUN = 255 - RLE_RUN + RLE_MIN_RUN;
+
+
+	static bool decode_index_rle(ByteView const& src, u8* dst, u32 length)
+	{
+		auto s = src.data;
+		auto s_end = src.data + src.length;
+		auto d_end = dst + length;
+
+		while (s < s_end && dst < d_end)
+		{
+			u32 c = *s++;
+
+			if (c < RLE_RUN)
+			{
+				auto n = c + 1;
+				if (s + n > s_end || dst + n > d_end)
+				{
+					return false;
+				}
+
+				for (u32 i = 0; i < n; i++)
+				{
+					dst[i] = s[i];
+				}
+
+				s += n;
+				dst += n;
+			}
+			else
+			{
+				auto n = c - RLE_RUN + RLE_MIN_RUN;
+				if (s == s_end || dst + n > d_end)
+				{
+					return false;
+				}
+
+				auto value = *s++;
+				for (u32 i = 0; i < n; i++)
+				{
+					dst[i] = value;
+				}
+
+				dst += n;
+			}
+		}
+
+		return s == s_end && dst == d_end;
+	}
+
+
+	static bool read_index_plane(ByteView const& src, AssetInfo_Image const& info, ImageGray& dst)
+	{
+		auto length = info.width * info.height;
+
+		if (info.type == FileType::Image1C_IndexRaw && src.length != length)
+		{
+			return false;
+		}
+
+		if (!img::create_image(dst, info.width, info.height))
+		{
+			return false;
+		}
+
+		switch (info.type)
+		{
+		case FileType::Image1C_IndexRaw:
+			for (u32 i = 0; i < length; i++)
+			{
+				dst.data_[i] = src.data[i];
+			}
+			return true;
+
+		case FileType::Image1C_IndexRLE:
+			return decode_index_rle(src, dst.data_, length);
+
+		default:
+			return false;
+		}
+	}
+
+
 	static u32 read_version_number(Buffer8 const& buffer)
 	{
 		// first 4 bytes
@@ -200,6 +309,11 @@ namespace bin_table
 			ok = img::read_image_from_memory(src, dst);
 			break;
 
+		case FileType::Image1C_IndexRaw:
+		case FileType::Image1C_IndexRLE:
+			ok = read_index_plane(src, info, dst);
+			break;
+
 		default: return ReadResult::Unsupported;
 		}
 
@@ -363,34 +477,67 @@ namespace bin_table
 
 	inline void alpha_filter_convert(SpanView<u8> const& src, SpanView<p32> const& dst, p32 primary)
 	{
-		constexpr auto off = img::to_pixel(0, 0, 0, 0);
-
+		// only AlphaFilter::Primary (255) is kept, everything else is off
 		primary.alpha = 255; // no transparency allowed
 
 		auto length = src.length;
 		auto s = src.data;
 		auto d = dst.data;
 
-		u8 alpha = 0;
+		u32 i = 0;
 
-		for (u32 i = 0; i < length; i++)
+	#if defined(BIN_TABLE_SIMD_256)
+
+		auto on = _mm256_set1_epi32((int)primary.rgba);
+		auto full = _mm256_set1_epi32(255);
+
+		for (; i + 8 <= length; i += 8)
 		{
-			/*alpha = s[i];
-			switch ((AlphaFilter)alpha)
-			{
-            case AlphaFilter::Primary:
-                d[i] = primary;
-                break;
+			auto a = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i const*)(s + i)));
+			auto mask = _mm256_cmpeq_epi32(a, full);
+			_mm256_storeu_si256((__m256i*)(d + i), _mm256_and_si256(mask, on));
+		}
 
-            default:
-				d[i] = off;
-                break;
-			}*/
+	#elif defined(BIN_TABLE_SIMD_WASM_128)
 
-			d[i].rgba = (s[i] / 255) * primary.rgba;
+		auto on = wasm_i32x4_splat((int)primary.rgba);
+		auto full = wasm_i8x16_splat(-1);
 
-			// filter preserved in alpha channel
-			//d[i].alpha = alpha;
+		for (; i + 16 <= length; i += 16)
+		{
+			// 0xFF mask bytes sign extend to 0xFFFFFFFF
+			auto mask = wasm_i8x16_eq(wasm_v128_load(s + i), full);
+			auto lo = wasm_i16x8_extend_low_i8x16(mask);
+			auto hi = wasm_i16x8_extend_high_i8x16(mask);
+
+			wasm_v128_store(d + i, wasm_v128_and(wasm_i32x4_extend_low_i16x8(lo), on));
+			wasm_v128_store(d + i + 4, wasm_v128_and(wasm_i32x4_extend_high_i16x8(lo), on));
+			wasm_v128_store(d + i + 8, wasm_v128_and(wasm_i32x4_extend_low_i16x8(hi), on));
+			wasm_v128_store(d + i + 12, wasm_v128_and(wasm_i32x4_extend_high_i16x8(hi), on));
+		}
+
+	#elif defined(BIN_TABLE_SIMD_SSE2)
+
+		auto on = _mm_set1_epi32((int)primary.rgba);
+		auto full = _mm_set1_epi8(-1);
+
+		for (; i + 16 <= length; i += 16)
+		{
+			auto mask = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)(s + i)), full);
+			auto lo = _mm_unpacklo_epi8(mask, mask);
+			auto hi = _mm_unpackhi_epi8(mask, mask);
+
+			_mm_storeu_si128((__m128i*)(d + i), _mm_and_si128(_mm_unpacklo_epi16(lo, lo), on));
+			_mm_storeu_si128((__m128i*)(d + i + 4), _mm_and_si128(_mm_unpackhi_epi16(lo, lo), on));
+			_mm_storeu_si128((__m128i*)(d + i + 8), _mm_and_si128(_mm_unpacklo_epi16(hi, hi), on));
+			_mm_storeu_si128((__m128i*)(d + i + 12), _mm_and_si128(_mm_unpackhi_epi16(hi, hi), on));
+		}
+
+	#endif
+
+		for (; i < length; i++)
+		{
+			d[i].rgba = (s[i] / 255) * primary.rgba;
 		}
 	}
 	
@@ -487,7 +634,30 @@ namespace bin_table
 		auto d = dst.matrix_data_;
 		auto t = table.rgba.data_;
 
-		for (u32 i = 0; i < length; i++)
+		u32 i = 0;
+
+	#if defined(BIN_TABLE_SIMD_256)
+
+		auto t32 = (int const*)t;
+
+		for (; i + 8 <= length; i += 8)
+		{
+			auto id = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i const*)(s + i)));
+			_mm256_storeu_si256((__m256i*)(d + i), _mm256_i32gather_epi32(t32, id, 4));
+		}
+
+	#elif defined(BIN_TABLE_SIMD_WASM_128)
+
+		// no gather, 4 lookups per store
+		for (; i + 4 <= length; i += 4)
+		{
+			auto v = wasm_u32x4_make(t[s[i]].rgba, t[s[i + 1]].rgba, t[s[i + 2]].rgba, t[s[i + 3]].rgba);
+			wasm_v128_store(d + i, v);
+		}
+
+	#endif
+
+		for (; i < length; i++)
 		{
 			d[i] = t[s[i]];
 		}
@@ -1,5 +1,8 @@
 #include "app.hpp"
 #include "../../../libs/math/math.hpp"
+#include "../../../libs/math/math_intrin.hpp"
+#include "../../../libs/math/math_random.hpp"
+#include "../../../libs/math/math_hash.hpp"
 
 
 #ifndef app_assert
@@ -29,6 +32,8 @@ namespace game_punk
     using ImageGray = img::ImageGray;
     using ImageView = img::ImageView;
     using SubView = img::SubView;
+    using GrayView = img::GrayView;
+    using GraySubView = img::GraySubView;
     using ImageMask = img::ImageGray;
     using Buffer8 = MemoryBuffer<u8>;
     using Buffer16 = MemoryBuffer<u16>;
@@ -64,6 +69,7 @@ namespace game_punk
 #include "sprite.hpp"
 #include "draw.hpp"
 #include "app_state.hpp"
+#include "snapshot.hpp"
 
 
 /* state */
@@ -106,6 +112,7 @@ namespace game_punk
         DrawQueue drawq;        
 
         TileTable tiles;
+        TileStrip tile_strip;
         SpriteTable sprites;
 
         PlayerState player_state;
@@ -120,11 +127,13 @@ namespace game_punk
 
         GameTick64 game_tick;
 
-        Randomf32 rng;
+        RandomState rng;
+
+        SnapshotRing snapshots;
     };
 
 
-    static void reset_state_data(StateData& data)
+    static void reset_state_data(StateData& data, u64 seed)
     {
         data.game_mode = GameMode::Title;
 
@@ -133,14 +142,193 @@ namespace game_punk
         reset_background_state(data.background);
         reset_game_scene(data.scene);
         reset_screen_camera(data.camera);
-        reset_random(data.rng);
+        invalidate_draw(data.drawq);
+        reset_random(data.rng, seed);
 
         reset_ui_state(data.ui);
         set_ui_color(data.ui, 20);
+        reset_player_state(data.player_state);
 
         reset_table(data.bitmaps);
         reset_tile_table(data.tiles);
+        reset_tile_strip(data.tile_strip);
         reset_sprite_table(data.sprites);
+        reset_snapshot_ring(data.snapshots);
+    }
+
+
+    // state saved by a snapshot
+    // pixels are redrawn, draw and load queues are rebuilt every frame
+    static void visit_snapshot(StateData& data, auto const& region)
+    {
+        auto const value = [&](auto& v) { region(&v, (u32)sizeof(v)); };
+        auto const array = [&](auto* a, u32 n) { region(a, n * (u32)sizeof(*a)); };
+
+        auto const slots = [&](SlotAllocator& s)
+        {
+            value(s.size);
+            value(s.n_free);
+            array(s.free_slots, s.capacity);
+            array(s.generation, s.capacity);
+            array(s.dense, s.capacity);
+            array(s.slot, s.capacity);
+        };
+
+        value(data.game_mode);
+        value(data.game_tick);
+        value(data.rng);
+
+        value(data.background);
+        value(data.ui.temp_icon);
+        value(data.scene);
+        value(data.camera);
+        value(data.player_state);
+
+        value(data.next_tile_position);
+        value(data.tile_bitmaps);
+        value(data.tile_strip);
+
+        auto& bitmaps = data.bitmaps;
+        value(bitmaps.size);
+        array(bitmaps.data, bitmaps.capacity);
+
+        auto& tiles = data.tiles;
+        auto NT = tiles.capacity;
+        slots(tiles.slots);
+        array(tiles.tick_begin, NT);
+        array(tiles.position, NT);
+        array(tiles.bitmap_id, NT);
+
+        auto& sprites = data.sprites;
+        auto NS = sprites.capacity;
+        slots(sprites.slots);
+        value(sprites.group_end);
+        array(sprites.name, NS);
+        array(sprites.mode, NS);
+        array(sprites.mode_begin, NS);
+        array(sprites.tick_end, NS);
+        array(sprites.acceleration_x, NS);
+        array(sprites.acceleration_y, NS);
+        array(sprites.speed_x, NS);
+        array(sprites.speed_y, NS);
+        array(sprites.position_x, NS);
+        array(sprites.position_y, NS);
+        array(sprites.animate, NS);
+        array(sprites.bitmap_id, NS);
+    }
+
+
+    static u32 snapshot_bytes(StateData& data)
+    {
+        u32 n_bytes = 0;
+        visit_snapshot(data, [&](void*, u32 n) { n_bytes += n; });
+
+        return n_bytes;
+    }
+
+
+    static void save_snapshot(StateData& data)
+    {
+        SnapshotCursor dst;
+        dst.slot = push_slot(data.snapshots);
+
+        visit_snapshot(data, [&](void* p, u32 n) { save_bytes(dst, p, n); });
+    }
+
+
+    static bool restore_snapshot(StateData& data, u32 n_back)
+    {
+        SnapshotCursor src;
+        src.slot = pop_slot(data.snapshots, n_back);
+        if (!src.slot)
+        {
+            return false;
+        }
+
+        visit_snapshot(data, [&](void* p, u32 n) { load_bytes(src, p, n); });
+
+        redraw_tile_strip(data.tile_strip, data.bitmaps);
+        invalidate_draw(data.drawq);
+
+        return true;
+    }
+
+
+    // simulation state without pointers, equal across runs and builds
+    static u64 hash_state(StateData const& data)
+    {
+        u64 h = 0;
+
+        auto const value = [&](auto const& v) { h = math::hash_bytes(&v, (u32)sizeof(v), h); };
+        auto const array = [&](auto const* a, u32 n) { h = math::hash_bytes(a, n * (u32)sizeof(*a), h); };
+
+        auto const slots = [&](SlotAllocator const& s)
+        {
+            value(s.size);
+            array(s.slot, s.size);
+            array(s.generation, s.capacity);
+        };
+
+        auto const background = [&](BackgroundAnimation const& an)
+        {
+            value(an.data_ids);
+            value(an.data_opacity);
+            value(an.load_pos);
+            value(an.current_background);
+            value(an.work_asset_ids.data);
+            value(an.work_asset_ids.cursor);
+            value(an.select_asset_ids.size);
+            value(an.select_asset_ids.data);
+        };
+
+        value(data.game_mode);
+        value(data.game_tick);
+        value(data.rng);
+
+        value(data.scene.game_position.pos_game());
+        value(data.camera.scene_position.pos_game());
+
+        auto& bg = data.background;
+        value(bg.sky.ov_pos.pos_game());
+        value(bg.sky.ov_vel);
+        background(bg.bg_1);
+        background(bg.bg_2);
+
+        value(data.player_state.sprite);
+        value(data.player_state.current_mode);
+
+        auto& tiles = data.tiles;
+        auto NT = tiles.size();
+        slots(tiles.slots);
+        array(tiles.tick_begin, NT);
+        array(tiles.position, NT);
+        array(tiles.bitmap_id, NT);
+
+        auto& sprites = data.sprites;
+        auto NS = sprites.size();
+        slots(sprites.slots);
+        value(sprites.group_end);
+        array(sprites.name, NS);
+        array(sprites.mode, NS);
+        array(sprites.mode_begin, NS);
+        array(sprites.tick_end, NS);
+        array(sprites.acceleration_x, NS);
+        array(sprites.acceleration_y, NS);
+        array(sprites.speed_x, NS);
+        array(sprites.speed_y, NS);
+        array(sprites.position_x, NS);
+        array(sprites.position_y, NS);
+        array(sprites.bitmap_id, NS);
+
+        return h;
+    }
+
+
+    static u64 hash_screen(StateData const& data)
+    {
+        auto dims = data.camera.dims.proc;
+
+        return math::hash_bytes(data.camera.pixels, dims.width * dims.height * (u32)sizeof(p32));
     }
 
 
@@ -159,6 +347,8 @@ namespace game_punk
 
         auto& data = get_data(state);
 
+        log_mem(data.memory);
+
         destroy_asset_data(data.asset_data);
         destroy_memory(data.memory);
 
@@ -182,10 +372,11 @@ namespace game_punk
         count_ui_state(data.ui, counts);
         count_queue(data.drawq, counts, 50);
         count_queue(data.loadq, counts, 10);
-        count_random(data.rng, counts);
         count_table(data.tiles, counts, 50);
+        count_tile_strip(data.tile_strip, counts);
         count_table(data.sprites, counts, 50);
         count_table(data.bitmaps, counts, 50);
+        count_snapshot_ring(data.snapshots, counts, snapshot_bytes(data));
         
         data.memory = create_memory(counts);
         if (!data.memory.ok)
@@ -201,10 +392,11 @@ namespace game_punk
         ok &= create_ui_state(data.ui, data.memory);
         ok &= create_queue(data.drawq, data.memory);
         ok &= create_queue(data.loadq, data.memory);
-        ok &= create_random(data.rng, data.memory);
         ok &= create_table(data.tiles, data.memory);
+        ok &= create_tile_strip(data.tile_strip, data.memory);
         ok &= create_table(data.sprites, data.memory);
         ok &= create_table(data.bitmaps, data.memory);
+        ok &= create_snapshot_ring(data.snapshots, data.memory);
 
         ok &= verify_allocated(data.memory);
 
@@ -304,17 +496,16 @@ namespace game_punk
 {
     static void begin_update(StateData& data)
     {
+        PROFILE_FRAME();
+
         ++data.game_tick;
         reset_draw(data.drawq); 
+        reset_scratch(data.memory);
     }
 
 
     static void end_update(StateData& data)
     {
-        refresh_random(data.rng);
-
-        
-
         load_all(data.asset_data, data.loadq);
     }
 
@@ -420,7 +611,7 @@ namespace game_punk
         ok &= init_screen_camera(camera, screen);
         ok &= init_animation_list(data.animations, data.spritesheets);
 
-        reset_state_data(data);
+        reset_state_data(data, DEFAULT_SEED);
 
         app_assert(ok && "*** Error set_screen_memory ***");
 
@@ -431,14 +622,51 @@ namespace game_punk
 
 
     void reset(AppState& state)
+    {
+        reset(state, get_data(state).rng.seed);
+    }
+
+
+    void reset(AppState& state, u64 seed)
     {
         auto& data = get_data(state);
-        reset_state_data(data);
+        reset_state_data(data, seed);
+
+        // same start as set_screen_memory
+        set_game_mode(data, GameMode::Title);
+    }
+
+
+    void save_snapshot(AppState& state)
+    {
+        save_snapshot(get_data(state));
+    }
+
+
+    bool restore_snapshot(AppState& state, u32 n_back)
+    {
+        return restore_snapshot(get_data(state), n_back);
+    }
+
+
+    u64 hash_state(AppState const& state)
+    {
+        return hash_state(get_data(state));
+    }
+
+
+    u64 hash_screen(AppState const& state)
+    {
+        return hash_screen(get_data(state));
     }
 
 
     void close(AppState& state)
     {
+    #ifdef GAME_PUNK_DRAW_MT
+        draw_mt::stop_pool();
+    #endif
+
         destroy_state_data(state);        
     }
 
@@ -482,6 +710,19 @@ namespace game_punk
     static void reset(DebugContext& dbg)
     {
         dbg.layers.all = 0xFF;
+
+        auto& hash = dbg.hash;
+        hash.tick = 0;
+        hash.state = 0;
+        hash.screen = 0;
+
+        for (u32 i = 0; i < dbg.HASH_HISTORY; i++)
+        {
+            hash.history_tick[i] = 0;
+            hash.history_state[i] = 0;
+        }
+
+        hash.history_cursor = 0;
     }
 
 
@@ -503,7 +744,7 @@ namespace game_punk
     }
 
 
-    void update_dbg(AppState& state, input::Input const& input, DebugContext const& dbg)
+    void update_dbg(AppState& state, input::Input const& input, DebugContext& dbg)
     {
         auto& data = get_data(state);        
         begin_update(data);
@@ -511,6 +752,16 @@ namespace game_punk
         game_mode_update(data, cmd);
         render_screen(data);
         end_update(data);
+
+        auto& hash = dbg.hash;
+        hash.tick = data.game_tick.value_;
+        hash.state = hash_state(data);
+        hash.screen = hash.screen_on ? hash_screen(data) : 0;
+
+        auto& c = hash.history_cursor;
+        hash.history_tick[c] = hash.tick;
+        hash.history_state[c] = hash.state;
+        c = (c + 1) % dbg.HASH_HISTORY;
     }
 
 #endif
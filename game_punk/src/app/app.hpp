@@ -2,6 +2,7 @@
 
 #include "../../../libs/io/input/input.hpp"
 #include "../../../libs/image/image.hpp"
+#include "profile.hpp"
 
 
 namespace game_punk
@@ -10,6 +11,9 @@ namespace game_punk
     constexpr auto VERSION = "0.4.1";
     constexpr auto DATE = "2026-02-03";
 
+    // random seed after set_screen_memory
+    constexpr u64 DEFAULT_SEED = 0;
+
 
     class StateData;
 
@@ -51,12 +55,27 @@ namespace game_punk
 
     bool set_screen_memory(AppState& state, image::ImageView screen);
 
+    // keeps the random seed of the current run
     void reset(AppState& state);
 
+    // same seed and inputs replay the same run
+    void reset(AppState& state, u64 seed);
+
     void close(AppState& state);
 
     void update(AppState& state, input::Input const& input);
 
+    // copies the game state into the snapshot ring, call after update
+    void save_snapshot(AppState& state);
+
+    // n_back = 0 is the most recent snapshot, false when it has been overwritten
+    bool restore_snapshot(AppState& state, u32 n_back);
+
+    // tables, tick, rng, player, scene, camera and backgrounds, equal across runs and builds
+    u64 hash_state(AppState const& state);
+
+    u64 hash_screen(AppState const& state);
+
     cstr decode_error(AppError error);
 }
 
@@ -71,6 +90,7 @@ namespace game_punk
     class DebugContext
     {
     public:
+        static constexpr u32 HASH_HISTORY = 8;
 
         union
         {
@@ -78,14 +98,29 @@ namespace game_punk
 
             
         } layers;
-        
+
+        // after the last update, runs diverge at the first tick with different hashes
+        struct
+        {
+            u64 tick = 0;
+            u64 state = 0;
+            u64 screen = 0;
+
+            b8 screen_on = 0;
+
+            // state hashes of the last updates, cleared on reset
+            u64 history_tick[HASH_HISTORY] = { 0 };
+            u64 history_state[HASH_HISTORY] = { 0 };
+            u32 history_cursor = 0;
+
+        } hash;
     };
 
 
     bool set_screen_memory_dbg(AppState& state, image::ImageView screen, DebugContext& dbg);
 
 
-    void update_dbg(AppState& state, input::Input const& input, DebugContext const& dbg);
+    void update_dbg(AppState& state, input::Input const& input, DebugContext& dbg);
 
 
 #endif
@@ -21,8 +21,6 @@ namespace game_punk
 
         ImageView fullscreen_view;
 
-        MemoryStack<p32> pixels;
-
         u8 font_color_id;
 
         struct 
@@ -49,8 +47,8 @@ namespace game_punk
         auto dims = CAMERA_DIMS.proc;
         count_view(ui.fullscreen_view, counts, dims.width, dims.height);
 
-        auto length = dims.width * dims.height;
-        count_stack(ui.pixels, counts, length);
+        // temporary images
+        add_scratch_count<p32>(counts, dims.width * dims.height);
     }
 
 
@@ -61,7 +59,6 @@ namespace game_punk
         ok &= create_view(ui.data.font, memory);
         ok &= create_view(ui.data.icons, memory);
         ok &= create_view(ui.fullscreen_view, memory);
-        ok &= create_stack(ui.pixels, memory);
 
         return ok;
     }
@@ -71,7 +68,6 @@ namespace game_punk
     {
         ui.temp_icon.is_on = 0;
         ui.temp_icon.end_tick = GameTick64::make(1);
-        reset_stack(ui.pixels);
     }
 
 
@@ -129,7 +125,8 @@ namespace game_punk
     }
 
 
-    static SpriteView get_ui_icon(UIState& ui, Randomf32& rng, GameTick64 game_tick)
+    // drawn in scratch memory, no data when scratch is full
+    static SpriteView get_ui_icon(UIState& ui, Memory& memory, RandomState& rng, GameTick64 game_tick)
     {
         auto& icons = ui.data.icons;
         auto dims = icons.bitmap_dims;
@@ -141,7 +138,15 @@ namespace game_punk
 
         SpriteView view;
         view.dims = dims;
-        view.data = push_elements(ui.pixels, length);
+        view.data = 0;
+
+        auto buffer = push_scratch<p32>(memory, length);
+        if (!buffer.ok)
+        {
+            return view;
+        }
+
+        view.data = buffer.data;
 
         auto dst = to_image_view(view);
 
@@ -159,9 +164,12 @@ namespace game_punk
 
         if (game_tick >= icon.end_tick)
         {
+            // flicker timing has its own stream, backgrounds draw the same ids with or without the icon
+            auto& flicker = random_stream(rng, RandomStream::UIIcon);
+
             icon.is_on = !icon.is_on;
 
-            auto delta = icon.is_on ? TickQty32::random(rng, 3, 40) : TickQty32::random(rng, 2, 10);
+            auto delta = icon.is_on ? TickQty32::random(flicker, 3, 40) : TickQty32::random(flicker, 2, 10);
             icon.end_tick = game_tick + delta;
         }
 
@@ -192,7 +200,14 @@ namespace game_punk
     };
 
 
-    static void set_player_mode(PlayerState& player, SpriteTable sprites, SpriteMode mode, GameTick64 tick)
+    static void reset_player_state(PlayerState& player)
+    {
+        player.sprite = {};
+        player.current_mode = SpriteMode::Idle;
+    }
+
+
+    static void set_player_mode(PlayerState& player, SpriteTable& sprites, SpriteMode mode, GameTick64 tick)
     {
         set_sprite_mode(sprites, player.sprite, mode, tick);
         player.current_mode = mode;
@@ -2,6 +2,7 @@
 
 #include "../../res/xbin/bin_table.hpp"
 #include "../../../libs/util/stack_buffer.hpp"
+#include "../../../libs/io/filesystem.hpp"
 
 
 /* asset constants */
@@ -188,71 +189,50 @@ namespace game_punk
 
 namespace game_punk
 {
-    class Randomf32
-    {
-    public:
-        static constexpr u32 capacity = 256;
+    using Random32 = math::Random32;
 
-        f32* values;
 
-        u8 b_cursor = 0;
-        u8 r_cursor = 0;
+    // independent sequences, drawing from one does not shift the others
+    enum class RandomStream : u8
+    {
+        Background = 0,
+        UIIcon,
+        Gameplay,
 
+        Count
     };
 
 
-    static void count_random(Randomf32& rng, MemoryCounts& counts)
-    {
-        add_count<f32>(counts, rng.capacity);
-    }
-
-
-    static bool create_random(Randomf32& rng, Memory& memory)
+    class RandomState
     {
-        auto res = push_mem<f32>(memory, rng.capacity);
-
-        if (res.ok)
-        {
-            rng.values = res.data;
-        }
+    public:
+        u64 seed = DEFAULT_SEED;
 
-        return res.ok;
-    }
+        Random32 streams[(u32)RandomStream::Count];
+    };
 
 
-    static void reset_random(Randomf32& rng)
+    static void reset_random(RandomState& rng, u64 seed)
     {
-        rng.b_cursor = 0;
-        rng.r_cursor = 0;
+        rng.seed = seed;
 
-        math::rand_init();
-
-        for (u32 i = 0; i < rng.capacity; i++)
+        for (u32 i = 0; i < (u32)RandomStream::Count; i++)
         {
-            rng.values[i] = math::rand(0.0f, 1.0f);
+            rng.streams[i] = math::make_random(seed, i);
         }
     }
 
 
-    static void refresh_random(Randomf32& rng)
+    static Random32& random_stream(RandomState& rng, RandomStream id)
     {
-        for (u8 i = rng.b_cursor; i < rng.r_cursor; i++)
-        {
-            rng.values[i] = math::rand(0.0f, 1.0f);
-        }
-
-        rng.b_cursor = rng.r_cursor;
+        return rng.streams[(u32)id];
     }
 
 
-    u32 next_random_u32(Randomf32& rng, u32 min, u32 max)
+    // [min, max]
+    static u32 next_random_u32(Random32& rng, u32 min, u32 max)
     {
-        auto val = rng.values[rng.r_cursor++];
-        app_assert(rng.r_cursor != rng.b_cursor && "*** Frame RNG exceded ***");
-
-        auto delta = val * (max - min) + 0.5f;
-
-        return min + (u32)delta;
+        return math::next_u32(rng, min, max);
     }
 }
 
@@ -325,7 +305,7 @@ namespace game_punk
         bool operator >= (TickQty32 other) const { return value_ >= other.value_; }
 
 
-        static TickQty32 random(Randomf32& rng, u32 min, u32 max) { return TickQty32(next_random_u32(rng, min, max)); }
+        static TickQty32 random(Random32& rng, u32 min, u32 max) { return TickQty32(next_random_u32(rng, min, max)); }
     };
 
 
@@ -412,7 +392,7 @@ namespace game_punk
 
         u32 id = 0;
 
-        T& get(Randomf32& rng) 
+        T& get(Random32& rng) 
         { 
             app_assert(size > 0 && "*** size not set ***");
             app_assert(size <= capacity && "*** size too large ***");
@@ -428,6 +408,150 @@ namespace game_punk
 }
 
 
+/* opacity */
+
+namespace game_punk
+{
+    enum class Opacity : u8
+    {
+        Mixed = 0,
+        Opaque,
+        Transparent
+    };
+
+
+    static Opacity get_opacity(u32 n_opaque, u32 n_transparent, u32 length)
+    {
+        if (n_opaque == length)
+        {
+            return Opacity::Opaque;
+        }
+
+        if (n_transparent == length)
+        {
+            return Opacity::Transparent;
+        }
+
+        return Opacity::Mixed;
+    }
+
+
+    static Opacity get_opacity(Span32 const& pixels)
+    {
+        u32 n_opaque = 0;
+        u32 n_transparent = 0;
+
+        for (u32 i = 0; i < pixels.length; i++)
+        {
+            auto a = pixels.data[i].alpha;
+            n_opaque += a == 255;
+            n_transparent += a == 0;
+        }
+
+        return get_opacity(n_opaque, n_transparent, pixels.length);
+    }
+}
+
+
+/* alpha runs */
+
+namespace game_punk
+{
+    // pixels with non-zero alpha, as drawn by img::copy_if_alpha
+    class AlphaRun
+    {
+    public:
+        u16 x;
+        u16 length;
+    };
+
+
+    class AlphaRuns
+    {
+    public:
+        // runs of row y are runs[row_begin[y]..row_begin[y + 1]]
+        u32* row_begin = 0;
+        AlphaRun* runs = 0;
+    };
+
+
+    static u32 max_alpha_runs(u32 width, u32 height)
+    {
+        return height * ((width + 1) / 2);
+    }
+
+
+    static void count_runs(MemoryCounts& counts, u32 width, u32 height)
+    {
+        add_count<u32>(counts, height + 1);
+        add_count<AlphaRun>(counts, max_alpha_runs(width, height));
+    }
+
+
+    static bool create_runs(AlphaRuns& ar, Memory& memory, u32 width, u32 height)
+    {
+        auto res_rows = push_mem<u32>(memory, height + 1);
+        auto res_runs = push_mem<AlphaRun>(memory, max_alpha_runs(width, height));
+
+        auto ok = res_rows.ok && res_runs.ok;
+        if (ok)
+        {
+            ar.row_begin = res_rows.data;
+            ar.runs = res_runs.data;
+        }
+
+        return ok;
+    }
+
+
+    static void encode_runs(AlphaRuns const& ar, ImageView const& view)
+    {
+        u32 n = 0;
+
+        for (u32 y = 0; y < view.height; y++)
+        {
+            ar.row_begin[y] = n;
+
+            auto row = img::row_span(view, y).data;
+
+            u32 x = 0;
+            while (x < view.width)
+            {
+                if (!row[x].alpha)
+                {
+                    x++;
+                    continue;
+                }
+
+                auto x_begin = x;
+                while (x < view.width && row[x].alpha)
+                {
+                    x++;
+                }
+
+                ar.runs[n++] = { (u16)x_begin, (u16)(x - x_begin) };
+            }
+        }
+
+        ar.row_begin[view.height] = n;
+    }
+
+
+    static AlphaRuns sub_runs(AlphaRuns const& ar, u32 y_begin)
+    {
+        if (!ar.row_begin)
+        {
+            return ar;
+        }
+
+        AlphaRuns sub = ar;
+        sub.row_begin += y_begin;
+
+        return sub;
+    }
+}
+
+
 /* object table */
 
 namespace game_punk
@@ -529,7 +653,17 @@ namespace game_punk
     }
 
 
-    using BitmapTable = ObjectTable<ImageView>;
+    class DrawBitmap
+    {
+    public:
+        ImageView view;
+
+        Opacity opacity = Opacity::Mixed;
+        AlphaRuns runs;
+    };
+
+
+    using BitmapTable = ObjectTable<DrawBitmap>;
     using BitmapID = BitmapTable::ID;  
     
     
@@ -544,6 +678,134 @@ namespace game_punk
 }
 
 
+/* slot allocator */
+
+namespace game_punk
+{
+    // stable slots for an SOA table that keeps live entries packed in [0, size)
+    class SlotAllocator
+    {
+    public:
+        u32 capacity = 0;
+        u32 size = 0;
+        u32 n_free = 0;
+
+        u32* free_slots = 0;
+        u32* generation = 0;
+
+        // slot -> dense index, capacity when free
+        u32* dense = 0;
+
+        // dense index -> slot
+        u32* slot = 0;
+    };
+
+
+    static void reset_slots(SlotAllocator& slots)
+    {
+        auto N = slots.capacity;
+
+        // lowest slots are taken first
+        // ids do not outlive a reset, generations start over so a replay allocates the same ids
+        for (u32 i = 0; i < N; i++)
+        {
+            slots.free_slots[i] = N - 1 - i;
+            slots.generation[i] = 0;
+            slots.dense[i] = N;
+        }
+
+        slots.n_free = N;
+        slots.size = 0;
+    }
+
+
+    static void count_slots(SlotAllocator& slots, MemoryCounts& counts, u32 capacity)
+    {
+        slots.capacity = capacity;
+
+        add_count<u32>(counts, capacity, 4);
+    }
+
+
+    static bool create_slots(SlotAllocator& slots, Memory& memory)
+    {
+        auto free_slots = push_mem<u32>(memory, slots.capacity);
+        auto generation = push_mem<u32>(memory, slots.capacity);
+        auto dense = push_mem<u32>(memory, slots.capacity);
+        auto slot = push_mem<u32>(memory, slots.capacity);
+
+        auto ok = free_slots.ok && generation.ok && dense.ok && slot.ok;
+        if (ok)
+        {
+            slots.free_slots = free_slots.data;
+            slots.generation = generation.data;
+            slots.dense = dense.data;
+            slots.slot = slot.data;
+            slots.n_free = 0;
+            slots.size = 0;
+        }
+
+        return ok;
+    }
+
+
+    static bool is_allocated(SlotAllocator const& slots, u32 slot, u32 generation)
+    {
+        return slot < slots.capacity && slots.generation[slot] == generation && slots.dense[slot] < slots.size;
+    }
+
+
+    // new slot goes to the end of the dense range, returns capacity when full
+    static u32 alloc_slot(SlotAllocator& slots)
+    {
+        if (!slots.n_free)
+        {
+            return slots.capacity;
+        }
+
+        auto s = slots.free_slots[--slots.n_free];
+        auto d = slots.size++;
+
+        slots.dense[s] = d;
+        slots.slot[d] = s;
+
+        return s;
+    }
+
+
+    // last dense entry moves into the freed one, returns the freed dense index
+    static u32 free_slot(SlotAllocator& slots, u32 slot)
+    {
+        app_assert(slots.dense[slot] < slots.size);
+
+        auto d = slots.dense[slot];
+        auto last = --slots.size;
+        auto moved = slots.slot[last];
+
+        slots.slot[d] = moved;
+        slots.dense[moved] = d;
+        slots.dense[slot] = slots.capacity;
+
+        slots.generation[slot]++;
+        slots.free_slots[slots.n_free++] = slot;
+
+        return d;
+    }
+
+
+    static void swap_dense(SlotAllocator& slots, u32 a, u32 b)
+    {
+        auto sa = slots.slot[a];
+        auto sb = slots.slot[b];
+
+        slots.slot[a] = sb;
+        slots.slot[b] = sa;
+        slots.dense[sa] = b;
+        slots.dense[sb] = a;
+    }
+}
+
+
 /* orientation context */
 
 namespace game_punk
@@ -660,7 +922,7 @@ namespace game_punk
 
     static i64 to_delta_px(TileDelta tile)
     {
-        return (i64)(cxpr::TILE_WIDTH_PX * tile.get());
+        return ((i64)tile.value_.value_ * cxpr::TILE_WIDTH_PX) >> units::TILE_VALUE_BITS;
     }
 
 
@@ -672,7 +934,7 @@ namespace game_punk
 
     static constexpr TileValue px_to_tile_value(i32 px)
     {
-        return TileValue::make((f32)px / cxpr::TILE_WIDTH_PX);
+        return TileValue::make((i32)(((i64)px << units::TILE_VALUE_BITS) / cxpr::TILE_WIDTH_PX));
     }
 
 
@@ -683,16 +945,21 @@ namespace game_punk
     }
 
 
-    template <typename T>
-    static TileDelta px_to_delta_tile(T px)
+    static TileDelta px_to_delta_tile(i32 delta_px)
     {
-        return px_to_delta_tile((f32)px);
+        return TileDelta::make(px_to_tile_value(delta_px));
+    }
+
+
+    static TileDelta px_to_delta_tile(u32 delta_px)
+    {
+        return px_to_delta_tile((i32)delta_px);
     }
 
 
     static u64 to_pixel_pos(TileDim tile)
     {
-        return (u64)(cxpr::TILE_WIDTH_PX * tile.get());
+        return tile.scale(cxpr::TILE_WIDTH_PX);
     }
 
 
@@ -892,12 +1159,22 @@ namespace game_punk
         cstr bin_file_path = 0;
 
         MemoryBuffer<u8> bytes;
+
+        b8 is_mapped = 0;
     };
 
 
     static void destroy_asset_data(AssetData& gd)
     {
-        mb::destroy_buffer(gd.bytes);
+        if (gd.is_mapped)
+        {
+            fs::unmap_bytes(gd.bytes);
+            gd.is_mapped = 0;
+        }
+        else
+        {
+            mb::destroy_buffer(gd.bytes);
+        }
     }
     
 }
@@ -982,6 +1259,8 @@ namespace game_punk
 
     static void load_all(AssetData const& src, LoadAssetQueue& q)
     {
+        PROFILE_ZONE(LoadAll);
+
         for (u32 i = 0; i < q.size; i++)
         {
             auto& cmd = q.commands[i];            
@@ -1068,6 +1347,8 @@ namespace game_punk
 
     static InputCommand map_input(Input const& input)
     {
+        PROFILE_ZONE(MapInput);
+
         auto& kbd = input.keyboard;
         auto& gpd = input.gamepad;
 
@@ -148,12 +148,13 @@ namespace assets
     }
 
 
-    static bool apply_color_table_blend(bt::TableFilterImage const& src, bt::ColorTableImage const& table, ImageView const& dst, p32 color, f32 alpha)
+    static bool apply_color_table_blend(bt::ColorTableImage const& table, ColorPalette const& dst, p32 color, f32 alpha)
     {
-        if (src.gray.width != dst.width || src.gray.height != dst.height)
-		{
-			return false;
-		}
+        auto length = table.rgba.width * table.rgba.height;
+        if (length > dst.count)
+        {
+            return false;
+        }
 
         auto ia = 1.0f - alpha;
 
@@ -163,14 +164,12 @@ namespace assets
 
         p32 ps;
 
-        auto length = dst.width * dst.height;
-        auto s = src.gray.data_;
-        auto d = dst.matrix_data_;
         auto t = table.rgba.data_;
+        auto d = dst.data;
 
         for (u32 i = 0; i < length; i++)
         {
-            ps = t[s[i]];
+            ps = t[i];
 
             r = ps.red * alpha + color.red * ia + 0.5f;
             g = ps.green * alpha + color.green * ia + 0.5f;
@@ -179,6 +178,12 @@ namespace assets
             d[i] = img::to_pixel((u8)r, (u8)g, (u8)b);
         }
 
+        // unused entries
+        for (u32 i = length; i < dst.count; i++)
+        {
+            d[i] = img::to_pixel(color.red, color.green, color.blue);
+        }
+
         return true;
     }
 
@@ -253,9 +258,13 @@ namespace assets
             return false;
         }
 
-        ok &= apply_color_table_blend(filter, table, to_image_view(dst), base_color, SKY_OVERLAY_ALPHA);
+        span::copy(filter.to_span(), to_span(dst));
 
-        app_assert(ok && "*** bt::color_table_convert() ***");
+        ok &= apply_color_table_blend(table, sky.palette, base_color, SKY_OVERLAY_ALPHA);
+
+        app_assert(ok && "*** apply_color_table_blend() ***");
+
+        sky.opacity = get_opacity(to_span(dst), sky.palette);
 
         table.destroy();
         filter.destroy();
@@ -271,7 +280,7 @@ namespace assets
 
         BG_DEF list;
 
-        constexpr auto N = sizeof(bg.background_data) / sizeof(bg.background_data[0]);
+        constexpr auto N = sizeof(bg.data_ids) / sizeof(bg.data_ids[0]);
 
         static_assert(BG_DEF::count >= N);
 
@@ -281,7 +290,7 @@ namespace assets
 
         bg.select_asset_ids.size = BG_DEF::count - bg.work_asset_ids.count;
 
-        bg.primary_color = color;
+        set_primary_color(bg, color);
 
         bool ok = true;
 
@@ -293,19 +302,17 @@ namespace assets
         {
             auto item = static_cast<BG_DEF::Items>(i);
             auto filter = list.read_alpha_filter_item(buffer, item);
-            span::copy(filter.to_span(), to_span(bg.background_filters.data[i]));
+            auto& mask = bg.background_filters.data[i];
+            pack_mask(filter.to_span(), mask);
+            bg.filter_opacity[i] = get_filter_opacity(mask);
             filter.destroy();
         }
 
-        // initial background_data
+        // initial backgrounds
         for (u32 i = 0; i < N; i++)
         {
-            auto item = static_cast<BG_DEF::Items>(i);
-            auto filter = list.read_alpha_filter_item(buffer, item);
-            auto dst = to_image_view(bg.background_data[i]);
-            ok &= bt::alpha_filter_convert(filter, dst, color);
-            app_assert(ok && "*** bt::alpha_filter_convert() ***");
-            filter.destroy();
+            bg.data_ids[i] = { (u16)i };
+            bg.data_opacity[i] = bg.filter_opacity[i];
         }
 
         return ok;
@@ -344,6 +351,10 @@ namespace assets
         ok &= bt::color_table_convert(jump, table, to_image_view(ss.punk_jump));
         app_assert(ok && "*** bt::color_table_convert() ***");
 
+        encode_runs(ss.punk_run.runs, to_image_view(ss.punk_run));
+        encode_runs(ss.punk_idle.runs, to_image_view(ss.punk_idle));
+        encode_runs(ss.punk_jump.runs, to_image_view(ss.punk_jump));
+
         table.destroy();
         run.destroy();
         idle.destroy();
@@ -360,7 +371,7 @@ namespace game_punk
 {
 namespace assets
 {
-    static bool load_tiles_ex_zone(Buffer8 const& buffer, TileState const& tiles)
+    static bool load_tiles_ex_zone(Buffer8 const& buffer, TileState& tiles)
     {
         using Ex = bt::Tileset_ex_zone;
 
@@ -377,6 +388,9 @@ namespace assets
         ok &= bt::color_table_convert(f3, table, to_image_view(tiles.floor_b));
         app_assert(ok && "*** bt::color_table_convert() ***");
 
+        tiles.opacity_a = get_opacity(to_span(tiles.floor_a));
+        tiles.opacity_b = get_opacity(to_span(tiles.floor_b));
+
         table.destroy();
         f2.destroy();
         f3.destroy();
@@ -447,7 +461,7 @@ namespace assets
     {
         bool ok = true;
         ok &= init_load_sky_overlay(src.bytes, bg_state.sky);
-        render_front_back(bg_state.sky);
+        bg_state.sky.version++;
 
         ok &= init_load_background<bt::Background_Bg1>(src.bytes, bg_state.bg_1, 8);
         ok &= init_load_background<bt::Background_Bg2>(src.bytes, bg_state.bg_2, 6);        
@@ -809,31 +823,42 @@ namespace assets
 #endif   
 
 
+    static bool read_asset_bytes(AssetData& dst, cstr path)
+    {
+        // map the file when the platform can, items are read in place
+        dst.bytes = fs::map_bytes(path);
+        dst.is_mapped = dst.bytes.ok;
+
+        if (!dst.is_mapped)
+        {
+            dst.bytes = fs::read_bytes(path);
+        }
+
+        return dst.bytes.ok;
+    }
+
+
     static bool load_asset_data(AssetData& dst)
     {
         cstr path = dst.bin_file_path;
-        auto& buffer = dst.bytes;
 
         if (path)
         {
-            buffer = fs::read_bytes(path);
-            if (buffer.ok)
+            if (read_asset_bytes(dst, path))
             {
                 return true;
             }
         }
 
         path = GAME_DATA_PATH;
-        buffer = fs::read_bytes(path);
-        if (buffer.ok)
+        if (read_asset_bytes(dst, path))
         {
             dst.bin_file_path = path;
             return true;
         }
 
         path = GAME_DATA_PATH_FALLBACK;
-        buffer = fs::read_bytes(path);
-        if (buffer.ok)
+        if (read_asset_bytes(dst, path))
         {
             dst.bin_file_path = path;
             return true;
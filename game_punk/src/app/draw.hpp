@@ -1,10 +1,51 @@
 #pragma once
 
+#ifdef __EMSCRIPTEN__
+#undef GAME_PUNK_DRAW_MT
+#endif
 
-/* draw */
+
+/* draw queue */
 
 namespace game_punk
 {
+    class DirtyTiles
+    {
+    public:
+        static constexpr u32 tile_px = 16;
+
+        u32 width = 0;
+        u32 height = 0;
+
+        u64* hash_prev;
+        u64* hash_next;
+        u8* dirty;
+
+        u32 n_dirty = 0;
+        bool all_dirty = true;
+        bool invalid = true;
+    };
+
+
+    class CoverRows
+    {
+    public:
+        u32 height = 0;
+
+        // opaque x range per camera row
+        u32* x_begin;
+        u32* x_end;
+    };
+
+
+    enum class DrawSource : u8
+    {
+        Image,
+        Palette,
+        Mask
+    };
+
+
     class DrawQueue
     {
     public:
@@ -14,13 +55,55 @@ namespace game_punk
 
         SubView* src;
         SubView* dst;
+        u32* tag;
+        Opacity* opacity;
+        AlphaRuns* runs;
+        DrawSource* source;
+
+        // index plane entries, expanded through the palette when drawn
+        GraySubView* src_index;
+        p32 const** palette;
+
+        // bit mask entries, set bits are drawn with color
+        MaskSubView* src_mask;
+        p32* color;
+
+        // visible rows relative to dst after culling
+        u32* row_begin;
+        u32* row_end;
+
+        DirtyTiles tiles;
+        CoverRows cover;
     };
 
 
     void count_queue(DrawQueue& dq, MemoryCounts& counts, u32 capacity)
     {
+        constexpr auto T = DirtyTiles::tile_px;
+
+        auto dims = CAMERA_DIMS.proc;
+
         dq.capacity = capacity;
-        add_count<SubView>(counts, 2 * capacity);
+        add_count<SubView>(counts, capacity, 2);
+        add_count<u32>(counts, capacity, 3);
+        add_count<Opacity>(counts, capacity);
+        add_count<AlphaRuns>(counts, capacity);
+        add_count<GraySubView>(counts, capacity);
+        add_count<p32 const*>(counts, capacity);
+        add_count<DrawSource>(counts, capacity);
+        add_count<MaskSubView>(counts, capacity);
+        add_count<p32>(counts, capacity);
+
+        auto& tiles = dq.tiles;
+        tiles.width = (dims.width + T - 1) / T;
+        tiles.height = (dims.height + T - 1) / T;
+
+        auto n_tiles = tiles.width * tiles.height;
+        add_count<u64>(counts, n_tiles, 2);
+        add_count<u8>(counts, n_tiles);
+
+        dq.cover.height = dims.height;
+        add_count<u32>(counts, dims.height, 2);
     }
 
 
@@ -32,43 +115,698 @@ namespace game_punk
             return false;
         }
 
+        auto& tiles = dq.tiles;
+        auto n_tiles = tiles.width * tiles.height;
+
         auto res_src = push_mem<SubView>(mem, dq.capacity);
         auto res_dst = push_mem<SubView>(mem, dq.capacity);
-
-        auto ok = res_src.ok && res_dst.ok;
+        auto res_tag = push_mem<u32>(mem, dq.capacity);
+        auto res_opacity = push_mem<Opacity>(mem, dq.capacity);
+        auto res_runs = push_mem<AlphaRuns>(mem, dq.capacity);
+        auto res_index = push_mem<GraySubView>(mem, dq.capacity);
+        auto res_palette = push_mem<p32 const*>(mem, dq.capacity);
+        auto res_source = push_mem<DrawSource>(mem, dq.capacity);
+        auto res_mask = push_mem<MaskSubView>(mem, dq.capacity);
+        auto res_color = push_mem<p32>(mem, dq.capacity);
+        auto res_row_begin = push_mem<u32>(mem, dq.capacity);
+        auto res_row_end = push_mem<u32>(mem, dq.capacity);
+        auto res_prev = push_mem<u64>(mem, n_tiles);
+        auto res_next = push_mem<u64>(mem, n_tiles);
+        auto res_dirty = push_mem<u8>(mem, n_tiles);
+        auto res_cover_begin = push_mem<u32>(mem, dq.cover.height);
+        auto res_cover_end = push_mem<u32>(mem, dq.cover.height);
+
+        auto ok = res_src.ok && res_dst.ok && res_tag.ok && res_opacity.ok && res_runs.ok && res_row_begin.ok && res_row_end.ok;
+        ok &= res_index.ok && res_palette.ok;
+        ok &= res_source.ok && res_mask.ok && res_color.ok;
+        ok &= res_prev.ok && res_next.ok && res_dirty.ok;
+        ok &= res_cover_begin.ok && res_cover_end.ok;
 
         if (ok)
         {
             dq.src = res_src.data;
             dq.dst = res_dst.data;
+            dq.tag = res_tag.data;
+            dq.opacity = res_opacity.data;
+            dq.runs = res_runs.data;
+            dq.src_index = res_index.data;
+            dq.palette = res_palette.data;
+            dq.source = res_source.data;
+            dq.src_mask = res_mask.data;
+            dq.color = res_color.data;
+            dq.row_begin = res_row_begin.data;
+            dq.row_end = res_row_end.data;
+
+            dq.cover.x_begin = res_cover_begin.data;
+            dq.cover.x_end = res_cover_end.data;
+
+            tiles.hash_prev = res_prev.data;
+            tiles.hash_next = res_next.data;
+            tiles.dirty = res_dirty.data;
+            tiles.invalid = true;
         }
 
         return ok;
     }
 
 
-    static void draw(DrawQueue const& dq)
+    static void invalidate_draw(DrawQueue& dq)
+    {
+        dq.tiles.invalid = true;
+    }
+}
+
+
+/* dirty tiles */
+
+namespace game_punk
+{
+namespace dirty
+{
+    static inline u64 hash_combine(u64 h, u64 v)
+    {
+        // FNV-1a style mix, order dependent
+        h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+        return h * 0x100000001B3ull;
+    }
+
+
+    template <class VIEW>
+    static u64 entry_hash(VIEW const& src, SubView const& dst, u32 tag)
+    {
+        u64 h = (u64)(uintptr_t)src.matrix_data_;
+        h = hash_combine(h, ((u64)src.x_begin << 32) | src.y_begin);
+        h = hash_combine(h, ((u64)dst.x_begin << 32) | dst.y_begin);
+        h = hash_combine(h, ((u64)dst.width << 32) | dst.height);
+        h = hash_combine(h, ((u64)src.matrix_width << 32) | tag);
+
+        return h;
+    }
+
+
+    static u64 entry_hash(DrawQueue const& dq, u32 i)
+    {
+        auto& dst = dq.dst[i];
+        auto tag = dq.tag[i];
+
+        switch (dq.source[i])
+        {
+        case DrawSource::Palette:
+            return hash_combine(entry_hash(dq.src_index[i], dst, tag), (u64)(uintptr_t)dq.palette[i]);
+
+        case DrawSource::Mask:
+            return hash_combine(entry_hash(dq.src_mask[i], dst, tag), dq.color[i].rgba);
+
+        default:
+            return entry_hash(dq.src[i], dst, tag);
+        }
+    }
+
+
+    static Rect2Du32 tile_range(SubView const& dst)
+    {
+        constexpr auto T = DirtyTiles::tile_px;
+
+        Rect2Du32 r{};
+        r.x_begin = dst.x_begin / T;
+        r.y_begin = dst.y_begin / T;
+        r.x_end = (dst.x_begin + dst.width + T - 1) / T;
+        r.y_end = (dst.y_begin + dst.height + T - 1) / T;
+
+        return r;
+    }
+
+
+    // the first entry must be opaque and cover the whole camera, as the sky does
+    static bool has_opaque_base(DrawQueue const& dq)
+    {
+        if (!dq.size)
+        {
+            return false;
+        }
+
+        auto dims = CAMERA_DIMS.proc;
+        auto& dst = dq.dst[0];
+
+        auto covers = dst.x_begin == 0 && dst.y_begin == 0 && dst.width == dims.width && dst.height == dims.height;
+
+        return covers && dq.opacity[0] == Opacity::Opaque;
+    }
+
+
+    // a dirty tile is repainted from the first entry up without clearing it first
+    // this is only correct over an opaque base layer that covers every tile,
+    // otherwise translucent pixels from the previous frame would show through
+    // without that base every tile is dirty
+    static void update_tiles(DrawQueue& dq)
     {
+        auto& tiles = dq.tiles;
+
+        auto W = tiles.width;
+        auto N = tiles.width * tiles.height;
+
+        auto prev = tiles.hash_prev;
+        auto next = tiles.hash_next;
+
+        for (u32 t = 0; t < N; t++)
+        {
+            next[t] = 0;
+        }
+
         for (u32 i = 0; i < dq.size; i++)
         {
-            img::copy_if_alpha(dq.src[i], dq.dst[i]);
+            auto& dst = dq.dst[i];
+            if (!dst.width || !dst.height)
+            {
+                continue;
+            }
+
+            auto h = entry_hash(dq, i);
+            auto r = tile_range(dst);
+
+            for (u32 ty = r.y_begin; ty < r.y_end; ty++)
+            {
+                auto row = next + ty * W;
+                for (u32 tx = r.x_begin; tx < r.x_end; tx++)
+                {
+                    row[tx] = hash_combine(row[tx], h);
+                }
+            }
+        }
+
+        u32 n_dirty = 0;
+
+        if (tiles.invalid || !has_opaque_base(dq))
+        {
+            for (u32 t = 0; t < N; t++)
+            {
+                tiles.dirty[t] = 1;
+            }
+            n_dirty = N;
         }
+        else
+        {
+            for (u32 t = 0; t < N; t++)
+            {
+                tiles.dirty[t] = next[t] != prev[t];
+                n_dirty += tiles.dirty[t];
+            }
+        }
+
+        tiles.n_dirty = n_dirty;
+        tiles.all_dirty = n_dirty == N;
+        tiles.invalid = false;
+
+        tiles.hash_prev = next;
+        tiles.hash_next = prev;
     }
 
 
-    static void reset_draw(DrawQueue& dq)
+    static void copy_runs(SubView const& src, SubView const& dst, AlphaRuns const& ar)
     {
-        dq.size = 0;
+        auto x_begin = src.x_begin;
+        auto x_end = src.x_begin + src.width;
+
+        for (u32 y = 0; y < src.height; y++)
+        {
+            auto s = img::row_begin(src, y) - x_begin;
+            auto d = img::row_begin(dst, y) - x_begin;
+
+            auto sy = src.y_begin + y;
+            auto r_begin = ar.row_begin[sy];
+            auto r_end = ar.row_begin[sy + 1];
+
+            for (u32 r = r_begin; r < r_end; r++)
+            {
+                auto run = ar.runs[r];
+
+                u32 rx_begin = math::max((u32)run.x, x_begin);
+                u32 rx_end = math::min((u32)run.x + run.length, x_end);
+
+                if (rx_begin >= rx_end)
+                {
+                    continue;
+                }
+
+                auto len = rx_end - rx_begin;
+                span::copy(span::make_view(s + rx_begin, len), span::make_view(d + rx_begin, len));
+            }
+        }
+    }
+
+
+    static void copy_mask(MaskSubView const& src, SubView const& dst, p32 color)
+    {
+        auto c = color.rgba;
+
+        for (u32 y = 0; y < src.height; y++)
+        {
+            auto s = row_words_begin(src, y);
+            auto d = img::row_begin(dst, y);
+
+            u32 x = 0;
+            while (x < src.width)
+            {
+                // up to the end of the current word, aligned after the first
+                auto sx = src.x_begin + x;
+                auto b = sx & 63;
+                auto n = math::min(64 - b, src.width - x);
+
+                auto full = n < 64 ? ((u64)1 << n) - 1 : ~(u64)0;
+                auto bits = (s[sx >> 6] >> b) & full;
+
+                if (bits == full)
+                {
+                    span::fill_u32((u32*)(d + x), c, n);
+                }
+                else
+                {
+                    while (bits)
+                    {
+                        d[x + std::countr_zero(bits)].rgba = c;
+                        bits &= bits - 1;
+                    }
+                }
+
+                x += n;
+            }
+        }
+    }
+
+
+    static void blit_entry(DrawQueue const& dq, u32 i, Rect2Du32 const& rr)
+    {
+        auto dst = img::sub_view(dq.dst[i], rr);
+
+        if (dq.source[i] == DrawSource::Mask)
+        {
+            if (dq.opacity[i] == Opacity::Opaque)
+            {
+                img::fill(dst, dq.color[i]);
+            }
+            else
+            {
+                copy_mask(sub_view(dq.src_mask[i], rr), dst, dq.color[i]);
+            }
+
+            return;
+        }
+
+        if (dq.source[i] == DrawSource::Palette)
+        {
+            auto index = img::sub_view(dq.src_index[i], rr);
+
+            if (dq.opacity[i] == Opacity::Opaque)
+            {
+                img::copy_palette(index, dst, dq.palette[i]);
+            }
+            else
+            {
+                img::copy_palette_if_alpha(index, dst, dq.palette[i]);
+            }
+
+            return;
+        }
+
+        auto src = img::sub_view(dq.src[i], rr);
+
+        if (dq.opacity[i] == Opacity::Opaque)
+        {
+            img::copy(src, dst);
+        }
+        else if (dq.runs[i].row_begin)
+        {
+            copy_runs(src, dst, dq.runs[i]);
+        }
+        else
+        {
+            img::copy_if_alpha(src, dst);
+        }
     }
 
 
-    static void push_draw_view(DrawQueue& dq, ImageView const& bmp, ImageView const& out, Point2Di32 out_pos)
+    static void draw_entry_rows(DrawQueue const& dq, u32 i, u32 ty_begin, u32 ty_end)
     {
-        if (!bmp.matrix_data_)
+        constexpr auto T = DirtyTiles::tile_px;
+
+        auto& tiles = dq.tiles;
+        auto& dst = dq.dst[i];
+
+        // rows not hidden by later opaque entries
+        auto y_begin = dst.y_begin + dq.row_begin[i];
+        auto y_end = dst.y_begin + dq.row_end[i];
+
+        if (y_begin >= y_end)
+        {
+            return;
+        }
+
+        auto r = tile_range(dst);
+        r.y_begin = math::max(r.y_begin, ty_begin, y_begin / T);
+        r.y_end = math::min(r.y_end, ty_end, (y_end + T - 1) / T);
+
+        if (r.y_begin >= r.y_end)
+        {
+            return;
+        }
+
+        auto W = tiles.width;
+
+        auto x_end = dst.x_begin + dst.width;
+
+        // dst relative
+        Rect2Du32 rr{};
+
+        if (tiles.all_dirty)
         {
+            rr.x_begin = 0;
+            rr.x_end = dst.width;
+            rr.y_begin = math::max(r.y_begin * T, y_begin) - dst.y_begin;
+            rr.y_end = math::min(r.y_end * T, y_end) - dst.y_begin;
+
+            blit_entry(dq, i, rr);
             return;
         }
 
+        for (u32 ty = r.y_begin; ty < r.y_end; ty++)
+        {
+            auto row = tiles.dirty + ty * W;
+
+            rr.y_begin = math::max(ty * T, y_begin) - dst.y_begin;
+            rr.y_end = math::min((ty + 1) * T, y_end) - dst.y_begin;
+
+            u32 tx = r.x_begin;
+            while (tx < r.x_end)
+            {
+                if (!row[tx])
+                {
+                    tx++;
+                    continue;
+                }
+
+                auto tx_begin = tx;
+                while (tx < r.x_end && row[tx])
+                {
+                    tx++;
+                }
+
+                rr.x_begin = math::max(tx_begin * T, dst.x_begin) - dst.x_begin;
+                rr.x_end = math::min(tx * T, x_end) - dst.x_begin;
+
+                blit_entry(dq, i, rr);
+            }
+        }
+    }
+
+
+    static void draw_band(DrawQueue const& dq, u32 ty_begin, u32 ty_end)
+    {
+        for (u32 i = 0; i < dq.size; i++)
+        {
+            draw_entry_rows(dq, i, ty_begin, ty_end);
+        }
+    }
+}
+}
+
+
+/* cull */
+
+namespace game_punk
+{
+namespace cull
+{
+    static inline bool is_covered(CoverRows const& cover, u32 y, u32 x_begin, u32 x_end)
+    {
+        return cover.x_begin[y] <= x_begin && x_end <= cover.x_end[y];
+    }
+
+
+    static inline void add_cover(CoverRows const& cover, u32 y, u32 x_begin, u32 x_end)
+    {
+        auto& cb = cover.x_begin[y];
+        auto& ce = cover.x_end[y];
+
+        if (cb < ce && x_begin <= ce && cb <= x_end)
+        {
+            cb = math::min(cb, x_begin);
+            ce = math::max(ce, x_end);
+        }
+        else if (x_end - x_begin > ce - cb)
+        {
+            // keep the widest range only
+            cb = x_begin;
+            ce = x_end;
+        }
+    }
+
+
+    static void cull_queue(DrawQueue const& dq)
+    {
+        auto& cover = dq.cover;
+
+        for (u32 y = 0; y < cover.height; y++)
+        {
+            cover.x_begin[y] = 0;
+            cover.x_end[y] = 0;
+        }
+
+        // back to front, trim rows hidden by later opaque entries
+        for (u32 i = dq.size; i-- > 0;)
+        {
+            auto& dst = dq.dst[i];
+
+            auto x_begin = dst.x_begin;
+            auto x_end = dst.x_begin + dst.width;
+
+            u32 rb = 0;
+            u32 re = dst.height;
+
+            while (rb < re && is_covered(cover, dst.y_begin + rb, x_begin, x_end))
+            {
+                rb++;
+            }
+
+            while (re > rb && is_covered(cover, dst.y_begin + re - 1, x_begin, x_end))
+            {
+                re--;
+            }
+
+            dq.row_begin[i] = rb;
+            dq.row_end[i] = re;
+
+            if (dq.opacity[i] != Opacity::Opaque)
+            {
+                continue;
+            }
+
+            for (u32 y = rb; y < re; y++)
+            {
+                add_cover(cover, dst.y_begin + y, x_begin, x_end);
+            }
+        }
+    }
+}
+}
+
+
+/* draw threads */
+
+#ifdef GAME_PUNK_DRAW_MT
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace game_punk
+{
+namespace draw_mt
+{
+    constexpr u32 MAX_WORKERS = 7;
+
+    // bands smaller than this are not worth waking the workers
+    constexpr u32 MIN_BAND_DIRTY = 32;
+
+
+    class WorkerPool
+    {
+    public:
+        std::thread workers[MAX_WORKERS];
+        u32 n_workers = 0;
+        u32 n_bands = 0;
+
+        std::mutex mtx;
+        std::condition_variable cv_start;
+        std::condition_variable cv_done;
+
+        u64 generation = 0;
+        u32 n_pending = 0;
+        bool stop = false;
+
+        DrawQueue const* dq = 0;
+
+
+        ~WorkerPool() { shutdown(); }
+
+
+        void shutdown()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                stop = true;
+            }
+
+            cv_start.notify_all();
+
+            for (u32 i = 0; i < n_workers; i++)
+            {
+                workers[i].join();
+            }
+
+            n_workers = 0;
+            stop = false;
+        }
+    };
+
+
+    static WorkerPool pool;
+
+
+    static void draw_band_id(DrawQueue const& dq, u32 band, u32 n_bands)
+    {
+        auto H = dq.tiles.height;
+
+        dirty::draw_band(dq, band * H / n_bands, (band + 1) * H / n_bands);
+    }
+
+
+    static void worker_proc(u32 band, u64 gen)
+    {
+        while (true)
+        {
+            DrawQueue const* dq = 0;
+            u32 n_bands = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(pool.mtx);
+                pool.cv_start.wait(lock, [&]{ return pool.stop || pool.generation != gen; });
+
+                if (pool.stop)
+                {
+                    return;
+                }
+
+                gen = pool.generation;
+                dq = pool.dq;
+                n_bands = pool.n_bands;
+            }
+
+            draw_band_id(*dq, band, n_bands);
+
+            {
+                std::lock_guard<std::mutex> lock(pool.mtx);
+                pool.n_pending--;
+            }
+
+            pool.cv_done.notify_one();
+        }
+    }
+
+
+    static void start_pool()
+    {
+        if (pool.n_workers)
+        {
+            return;
+        }
+
+        auto n_threads = std::thread::hardware_concurrency();
+        auto n_workers = n_threads > 1 ? math::min(n_threads - 1, MAX_WORKERS) : 0u;
+
+        for (u32 i = 0; i < n_workers; i++)
+        {
+            // band 0 is drawn on the calling thread
+            pool.workers[i] = std::thread(worker_proc, i + 1, pool.generation);
+        }
+
+        pool.n_workers = n_workers;
+        pool.n_bands = n_workers + 1;
+    }
+
+
+    static void stop_pool()
+    {
+        pool.shutdown();
+    }
+
+
+    static bool draw_bands(DrawQueue const& dq)
+    {
+        start_pool();
+
+        if (!pool.n_workers || dq.tiles.n_dirty < pool.n_bands * MIN_BAND_DIRTY)
+        {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(pool.mtx);
+            pool.dq = &dq;
+            pool.n_pending = pool.n_workers;
+            pool.generation++;
+        }
+
+        pool.cv_start.notify_all();
+
+        draw_band_id(dq, 0, pool.n_bands);
+
+        std::unique_lock<std::mutex> lock(pool.mtx);
+        pool.cv_done.wait(lock, []{ return pool.n_pending == 0; });
+
+        return true;
+    }
+}
+}
+
+#endif // GAME_PUNK_DRAW_MT
+
+
+/* draw */
+
+namespace game_punk
+{
+    static void draw(DrawQueue& dq)
+    {
+        PROFILE_ZONE(Draw);
+
+        dirty::update_tiles(dq);
+
+        if (!dq.tiles.n_dirty)
+        {
+            return;
+        }
+
+        cull::cull_queue(dq);
+
+    #ifdef GAME_PUNK_DRAW_MT
+        if (draw_mt::draw_bands(dq))
+        {
+            return;
+        }
+    #endif
+
+        dirty::draw_band(dq, 0, dq.tiles.height);
+    }
+
+
+    static void reset_draw(DrawQueue& dq)
+    {
+        dq.size = 0;
+    }
+
+
+    static bool clip_draw_rects(u32 width, u32 height, ImageView const& out, Point2Di32 out_pos, Rect2Du32& sr, Rect2Du32& dr)
+    {
         i32 w = (i32)out.width;
         i32 h = (i32)out.height;
         i32 x = out_pos.x;
@@ -83,22 +821,42 @@ namespace game_punk
         Rect2Di32 dst_rect{};
         dst_rect.x_begin = x;
         dst_rect.y_begin = y;
-        dst_rect.x_end = x + bmp.width;
-        dst_rect.y_end = y + bmp.height;
+        dst_rect.x_end = x + width;
+        dst_rect.y_end = y + height;
 
         if (!rect_intersect(screen_rect, dst_rect))
         {
-            return;
+            return false;
         }
 
-        auto dr = clamp_rect(dst_rect, screen_rect);
+        dr = clamp_rect(dst_rect, screen_rect);
 
-        Rect2Du32 sr{};
         sr.x_begin = (u32)math::max(0 - x, 0);
         sr.y_begin = (u32)math::max(0 - y, 0);
         sr.x_end = sr.x_begin + dr.x_end - dr.x_begin;
         sr.y_end = sr.y_begin + dr.y_end - dr.y_begin;
 
+        return true;
+    }
+
+
+    static void push_draw_view(DrawQueue& dq, DrawBitmap const& bitmap, ImageView const& out, Point2Di32 out_pos, u32 tag = 0)
+    {
+        auto& bmp = bitmap.view;
+
+        if (!bmp.matrix_data_ || bitmap.opacity == Opacity::Transparent)
+        {
+            return;
+        }
+
+        Rect2Du32 sr{};
+        Rect2Du32 dr{};
+
+        if (!clip_draw_rects(bmp.width, bmp.height, out, out_pos, sr, dr))
+        {
+            return;
+        }
+
         auto i = dq.size;
         dq.size++;
 
@@ -106,34 +864,87 @@ namespace game_punk
 
         dq.src[i] = img::sub_view(bmp, sr);
         dq.dst[i] = img::sub_view(out, dr);
+        dq.tag[i] = tag;
+        dq.opacity[i] = bitmap.opacity;
+        dq.runs[i] = bitmap.runs;
+        dq.source[i] = DrawSource::Image;
+    }
+
+
+    static void push_draw_view(DrawQueue& dq, GraySubView const& index, p32 const* palette, Opacity opacity, ImageView const& out, Point2Di32 out_pos, u32 tag)
+    {
+        if (!index.matrix_data_ || opacity == Opacity::Transparent)
+        {
+            return;
+        }
+
+        Rect2Du32 sr{};
+        Rect2Du32 dr{};
+
+        if (!clip_draw_rects(index.width, index.height, out, out_pos, sr, dr))
+        {
+            return;
+        }
+
+        auto i = dq.size;
+        dq.size++;
+
+        app_assert(dq.size <= dq.capacity && "Draw capacity");
+
+        dq.src_index[i] = img::sub_view(index, sr);
+        dq.dst[i] = img::sub_view(out, dr);
+        dq.tag[i] = tag;
+        dq.opacity[i] = opacity;
+        dq.runs[i] = AlphaRuns{};
+        dq.source[i] = DrawSource::Palette;
+        dq.palette[i] = palette;
+    }
+
+
+    static void push_draw_view(DrawQueue& dq, MaskView const& mask, p32 color, Opacity opacity, ImageView const& out, Point2Di32 out_pos, u32 tag)
+    {
+        if (!mask.matrix_data_ || opacity == Opacity::Transparent)
+        {
+            return;
+        }
+
+        Rect2Du32 sr{};
+        Rect2Du32 dr{};
+
+        if (!clip_draw_rects(mask.width, mask.height, out, out_pos, sr, dr))
+        {
+            return;
+        }
+
+        auto i = dq.size;
+        dq.size++;
+
+        app_assert(dq.size <= dq.capacity && "Draw capacity");
+
+        dq.src_mask[i] = sub_view(mask, sr);
+        dq.dst[i] = img::sub_view(out, dr);
+        dq.tag[i] = tag;
+        dq.opacity[i] = opacity;
+        dq.runs[i] = AlphaRuns{};
+        dq.source[i] = DrawSource::Mask;
+        dq.color[i] = color;
     }
    
 
-    static void push_draw(DrawQueue& dq, BackgroundView const& bg, SceneCamera const& camera)
+    static void push_draw(DrawQueue& dq, GraySubView const& bg, ColorPalette const& palette, SceneCamera const& camera, Opacity opacity, u32 tag)
     {
         constexpr auto zero = units::SceneDimension::zero();
 
-        auto bmp = to_image_view(bg);
         auto out = to_image_view(camera);
 
         ScenePosition pos(zero, zero, DimCtx::Proc);
 
         auto p = delta_pos_px(pos, camera.scene_position);
 
-        push_draw_view(dq, bmp, out, p);
+        push_draw_view(dq, bg, palette.data, opacity, out, p, tag);
     }
     
     
-    static void push_draw(DrawQueue& dq, GameImageView const& sprite, ScenePosition pos, SceneCamera const& camera)
-    {
-        auto bmp = to_image_view(sprite);
-        auto out = to_image_view(camera);
-        auto p = delta_pos_px(pos, camera.scene_position);
-
-        push_draw_view(dq, bmp, out, p);
-    }
-
-
     static void push_draw(DrawQueue& dq, BackgroundPartPair const& pair, SceneCamera const& camera)
     {
         auto out = to_image_view(camera);
@@ -141,27 +952,52 @@ namespace game_punk
         auto vs = make_vec_scene(0, 0);
         auto pos = ScenePosition(vs, DimCtx::Proc);
         auto p = delta_pos_px(pos, camera.scene_position);
-        auto bmp = to_image_view_first(pair);
 
-        push_draw_view(dq, bmp, out, p);
+        push_draw_view(dq, to_mask_view_first(pair), pair.color, pair.opacity1, out, p, pair.version);
 
         vs = make_vec_scene(0, pair.height1);
 
         pos = ScenePosition(vs, DimCtx::Proc);
         p = delta_pos_px(pos, camera.scene_position);
-        bmp = to_image_view_second(pair);
-        if (bmp.height)
+
+        auto second = to_mask_view_second(pair);
+        if (second.height)
+        {
+            push_draw_view(dq, second, pair.color, pair.opacity2, out, p, pair.version);
+        }
+    }
+
+
+    static void push_draw(DrawQueue& dq, TileStrip const& strip, GameScene const& scene, SceneCamera const& camera)
+    {
+        auto out = to_image_view(camera);
+        auto C = strip.capacity;
+
+        // two parts when the tiles wrap around the ring
+        auto tile = strip.begin;
+        while (tile < strip.end)
         {
-            push_draw_view(dq, bmp, out, p);
+            auto slot = tile % C;
+            auto n = math::min(strip.end - tile, C - slot);
+
+            DrawBitmap bmp;
+            bmp.view = slot_view(strip, slot, n);
+            bmp.opacity = strip.opacity;
+
+            auto p = delta_pos_px(tile_scene_pos(strip, tile, scene), camera.scene_position);
+
+            push_draw_view(dq, bmp, out, p, strip.version);
+
+            tile += n;
         }
     }
 
 
-    static void push_draw(DrawQueue& dq, ImageView const& view, ScenePosition pos, SceneCamera const& camera)
+    static void push_draw(DrawQueue& dq, DrawBitmap const& bitmap, ScenePosition pos, SceneCamera const& camera)
     {
         auto out = to_image_view(camera);
         auto p = delta_pos_px(pos, camera.scene_position);
 
-        push_draw_view(dq, view, out, p);
+        push_draw_view(dq, bitmap, out, p);
     }
 }
\ No newline at end of file
@@ -31,6 +31,22 @@ namespace internal
     }
 
 
+    static void spawn_floor_tile(StateData& data, VecTile pos)
+    {
+        auto bmp = data.tile_bitmaps.front();
+
+        auto id = spawn_tile(data.tiles, TileDef(data.game_tick, pos, bmp));
+        if (!is_alive(data.tiles, id))
+        {
+            return;
+        }
+
+        append_tile(data.tile_strip, data.bitmaps, bmp, pos);
+
+        data.tile_bitmaps.next();
+    }
+
+
     static void init_tiles(StateData& data)
     {
         constexpr auto zero = TileDim::zero();
@@ -39,16 +55,17 @@ namespace internal
         auto& src = data.tile_state;
         auto& bitmaps = data.tile_bitmaps;
         
-        bitmaps.data[0] = data.bitmaps.push_item(to_image_view(src.floor_a));
-        bitmaps.data[1] = data.bitmaps.push_item(to_image_view(src.floor_b));
+        bitmaps.data[0] = data.bitmaps.push_item({ to_image_view(src.floor_a), src.opacity_a });
+        bitmaps.data[1] = data.bitmaps.push_item({ to_image_view(src.floor_b), src.opacity_b });
+        bitmaps.cursor.reset();
+
+        reset_tile_strip(data.tile_strip);
 
         VecTile pos = { zero, zero };
         for (u32 i = 0; i < 20; i++)
         {
-            auto tile = TileDef(data.game_tick, pos, data.tile_bitmaps.front());
-            spawn_tile(data.tiles, tile);
+            spawn_floor_tile(data, pos);
             pos.x += one;
-            data.tile_bitmaps.next();
         }
 
         data.next_tile_position = TilePosition(pos, DimCtx::Game);
@@ -81,6 +98,11 @@ namespace internal
         auto& player = data.player_state;
         auto& sprites = data.sprites;
 
+        if (!is_alive(sprites, player.sprite))
+        {
+            return;
+        }
+
         auto mode = player.current_mode;
         auto tick = data.game_tick;
         
@@ -137,31 +159,60 @@ namespace internal
 
     static void update_tiles(StateData& data)
     {
+        PROFILE_ZONE(UpdateTiles);
+
         constexpr auto one = TileDelta::make(TileValue::make(1.0f));
         constexpr auto tile_w = cxpr::TILE_WIDTH_PX;
         constexpr auto limit = (i32)(cxpr::GAME_BACKGROUND_WIDTH_PX - 2 * tile_w);
 
+        constexpr i32 xmin = -(cxpr::GAME_BACKGROUND_WIDTH_PX / 4);
+        constexpr i32 ymin = -(cxpr::GAME_BACKGROUND_HEIGHT_PX / 4);
+        
         auto scene = to_scene_pos(data.next_tile_position, data.scene);
         
         auto delta = scene.pos_game().x.get();
 
         if (delta < limit)
         {
-            auto pos = data.next_tile_position.pos_game();
-            auto tile = TileDef(data.game_tick, pos, data.tile_bitmaps.front());
-            spawn_tile(data.tiles, tile);
+            spawn_floor_tile(data, data.next_tile_position.pos_game());
 
             data.next_tile_position.game.x += one;
-            data.tile_bitmaps.next();
+        }
+
+        auto& table = data.tiles;
+        auto& strip = data.tile_strip;
+
+        auto pos = table.position;
+
+        // despawn moves the last tile into i
+        u32 i = 0;
+        while (i < table.size())
+        {
+            auto gpos = to_scene_pos(pos[i], data.scene).pos_game();
+
+            if (gpos.x.get() < xmin || gpos.y.get() < ymin)
+            {
+                despawn_tile(table, table.id_at(i));
+                continue;
+            }
+
+            i++;
+        }
+
+        while (strip.begin < strip.end && tile_scene_pos(strip, strip.begin, data.scene).game.x.get() < xmin)
+        {
+            drop_tile(strip);
         }
     }
 
 
     static void animate_sprites(StateData& data)
     {
+        PROFILE_ZONE(AnimateSprites);
+
         auto& table = data.sprites;
 
-        auto N = table.capacity;
+        auto N = table.size();
 
         auto beg = table.mode_begin;
         auto afn = table.animate;
@@ -169,18 +220,13 @@ namespace internal
 
         for (u32 i = 0; i < N; i++)
         {
-            SpriteID id = { i };
-
-            if (!is_spawned(table, id))
-            {
-                continue;
-            }
-
-            auto vel = table.get_tile_velocity(id);
+            VecSpeed vel = { table.speed_x[i], table.speed_y[i] };
 
             auto time = data.game_tick - beg[i];
             auto view = afn[i](data.animations, vel, time);
-            data.bitmaps.item_at(bmp[i]) = to_image_view(view);
+            auto& bitmap = data.bitmaps.item_at(bmp[i]);
+            bitmap.view = to_image_view(view);
+            bitmap.runs = view.runs;
         }
     }
 }
@@ -192,10 +238,12 @@ namespace internal
 {
     static void draw_background(StateData& data)
     {
+        PROFILE_ZONE(DrawBackground);
+
         auto& bg = data.background;
         auto& dq = data.drawq;
         auto& camera = data.camera;
-        auto& rng = data.rng;
+        auto& rng = random_stream(data.rng, RandomStream::Background);
 
         auto tile = data.scene.game_position.pos_game().x;
 
@@ -205,7 +253,7 @@ namespace internal
         auto bg1 = get_animation_pair(bg.bg_1, rng, pos);
         auto bg2 = get_animation_pair(bg.bg_2, rng, pos);
         
-        push_draw(dq, sky, camera);
+        push_draw(dq, sky, bg.sky.palette, camera, bg.sky.opacity, bg.sky.version);
         push_draw(dq, bg1, camera);
         push_draw(dq, bg2, camera);        
     }
@@ -213,40 +261,7 @@ namespace internal
 
     static void draw_tiles(StateData& data)
     {
-        constexpr i32 xmin = -(cxpr::GAME_BACKGROUND_WIDTH_PX / 4);
-        constexpr i32 ymin = -(cxpr::GAME_BACKGROUND_HEIGHT_PX / 4);
-
-        auto& scene = data.scene;
-        auto& dq = data.drawq;
-        auto& camera = data.camera;
-        auto& table = data.tiles;
-
-        auto N = table.capacity;
-        
-        auto pos = table.position;
-        auto bmp = table.bitmap_id;
-
-        for (u32 i = 0; i < N; i++)
-        {
-            TileID id = { i };
-
-            if (!is_spawned(table, id))
-            {
-                continue;
-            }
-
-            auto spos = to_scene_pos(pos[i], scene);
-            auto gpos = spos.pos_game();
-
-            if (gpos.x.get() < xmin || gpos.y.get() < ymin)
-            {
-                despawn_tile(table, id);
-                continue;
-            }            
-
-            auto view = data.bitmaps.item_at(bmp[i]);
-            push_draw(dq, view, spos, camera);
-        }
+        push_draw(data.drawq, data.tile_strip, data.scene, data.camera);
     }
     
     
@@ -260,35 +275,38 @@ namespace internal
         auto& sprites = data.sprites;
 
         auto tick = data.game_tick;
-        auto N = sprites.capacity;
 
         auto beg = sprites.mode_begin;
         auto end = sprites.tick_end;
         auto bmp = sprites.bitmap_id;
 
-        for (u32 i = 0; i < N; i++)
+        // despawn walks the sprite at i through the later groups and swap-removes it,
+        // so i receives a later sprite from the group chain
+        // every swap touches only indices >= i, re-checking i visits each sprite once
+        u32 i = 0;
+        while (i < sprites.size())
         {
             if (tick >= end[i] || beg[i] > end[i])
             {
+                i++;
                 continue;
             }
 
-            SpriteID id = { i };
-
-            auto tile = sprites.get_tile_pos(id);
+            VecTile tile = { sprites.position_x[i], sprites.position_y[i] };
 
             auto spos = to_scene_pos(tile, data.scene);
             auto gpos = spos.pos_game();
 
             if (gpos.x.get() < xmin || gpos.y.get() < ymin)
             {
-                beg[i] = GameTick64::none();
-                sprites.first_id = math::min(i, sprites.first_id);
+                despawn_sprite(sprites, sprites.id_at(i));
                 continue;
             }
             
-            auto view = data.bitmaps.item_at(bmp[i]);
-            push_draw(dq, view, spos, camera);
+            auto& bitmap = data.bitmaps.item_at(bmp[i]);
+            push_draw(dq, bitmap, spos, camera);
+
+            i++;
         }
     }
 }
@@ -306,7 +324,8 @@ namespace gm_gameplay
         internal::init_punk_sprite(data);
         internal::init_tiles(data);
         
-        app_assert(data.player_state.sprite == PLAYER_ID && "*** Player not first sprite ***");
+        app_assert(is_alive(data.sprites, data.player_state.sprite) && "*** Player not spawned ***");
+        app_assert(data.player_state.sprite.value_ == PLAYER_ID.value_ && "*** Player not first sprite ***");
         
         data.game_tick = GameTick64::zero();
     }
@@ -319,11 +338,14 @@ namespace gm_gameplay
         
         move_sprites_xy(data.sprites, data.game_tick);
 
-        auto& scene_pos = data.scene.game_position.game;
-        auto player_pos = data.sprites.get_tile_x(data.player_state.sprite);
+        if (is_alive(data.sprites, data.player_state.sprite))
+        {
+            auto& scene_pos = data.scene.game_position.game;
+            auto player_pos = data.sprites.get_tile_x(data.player_state.sprite);
 
-        scene_pos.x = player_pos;
-        scene_pos.x -= px_to_delta_tile(PLAYER_SCENE_OFFSET);
+            scene_pos.x = player_pos;
+            scene_pos.x -= px_to_delta_tile(PLAYER_SCENE_OFFSET);
+        }
         
         internal::update_tiles(data);
         internal::animate_sprites(data);
@@ -19,8 +19,6 @@ namespace internal
         auto gw = screen.width;
         auto gh = screen.height;
 
-        auto& pixels = data.ui.pixels;
-
         bt::ColorTableImage table;
         table.rgba.height = 1;
         table.rgba.width = sizeof(src.table) / sizeof(src.table[0]);
@@ -32,7 +30,16 @@ namespace internal
         filter.gray.data_ = (u8*)src.keys;
 
         auto out = data.ui.fullscreen_view;
-        auto converted = img::make_view(sw, sh, push_elements(pixels, sw * sh));        
+
+        auto buffer = push_scratch<p32>(data.memory, sw * sh);
+        if (!buffer.ok)
+        {
+            // no title image, screen stays usable
+            img::fill(out, COLOR_BLACK);
+            return;
+        }
+
+        auto converted = img::make_view(sw, sh, buffer.data);
 
         bool ok = true;
 
@@ -51,8 +58,6 @@ namespace internal
         img::fill(out, color);
 
         img::scale_up(converted, scaled, scale);
-
-        reset_stack(data.ui.pixels);
     }
     
     
@@ -91,6 +96,9 @@ namespace gm_title
         auto& dq = data.drawq;
         auto& camera = data.camera;        
 
+        // title screen writes directly to the camera
+        invalidate_draw(dq);
+
         switch (data.asset_data.status)
         {
         case AssetStatus::None:
@@ -30,7 +30,11 @@ namespace game_punk
     }
     
     
-    class SpriteView : public GameImageView {};
+    class SpriteView : public GameImageView 
+    {
+    public:
+        AlphaRuns runs;
+    };
 }
 
 
@@ -83,115 +87,207 @@ namespace game_punk
 }
 
 
-/* background view */
+/* bit mask view */
+
+#include <bit>
 
 namespace game_punk
-{    
-    class BackgroundView
+{
+    // pixel x of a row is bit (x % 64) of word (x / 64)
+    class MaskView
     {
     public:
-        static constexpr auto dims = BACKGROUND_DIMS;
+        u64* matrix_data_ = 0;
+        u32 matrix_width = 0; // words per row
 
-        p32* data = 0;
+        u32 width = 0;
+        u32 height = 0;
     };
 
 
-    static void count_view(BackgroundView& view, MemoryCounts& counts)
+    class MaskSubView
     {
-        auto length = view.dims.proc.width * view.dims.proc.height;
-        add_count<p32>(counts, length);
-        view.data = 0;
+    public:
+        u64* matrix_data_ = 0;
+        u32 matrix_width = 0;
+
+        u32 x_begin = 0;
+        u32 y_begin = 0;
+
+        u32 width = 0;
+        u32 height = 0;
+    };
+
+
+    static constexpr u32 mask_row_words(u32 width)
+    {
+        return (width + 63) / 64;
     }
 
 
-    static bool create_view(BackgroundView& view, Memory& memory)
+    static MaskSubView sub_view(MaskView const& view, Rect2Du32 const& range)
     {
-        auto length = view.dims.proc.width * view.dims.proc.height;
+        app_assert(range.x_end <= view.width);
+        app_assert(range.y_end <= view.height);
 
-        auto res = push_mem<p32>(memory, length);
-        if (res.ok)
-        {
-            view.data = res.data;
-        }
+        MaskSubView sub;
 
-        return res.ok;
+        sub.matrix_data_ = view.matrix_data_;
+        sub.matrix_width = view.matrix_width;
+        sub.x_begin = range.x_begin;
+        sub.y_begin = range.y_begin;
+        sub.width = range.x_end - range.x_begin;
+        sub.height = range.y_end - range.y_begin;
+
+        return sub;
     }
 
 
-    static auto to_span_cx(BackgroundView const& view)
-    {      
-        constexpr auto W = cxpr::GAME_BACKGROUND_WIDTH_PX;
-        constexpr auto H = cxpr::GAME_BACKGROUND_HEIGHT_PX;
-        return Span32_cxpr<W, H>(view.data);
+    static MaskSubView sub_view(MaskSubView const& view, Rect2Du32 const& range)
+    {
+        app_assert(range.x_end <= view.width);
+        app_assert(range.y_end <= view.height);
+
+        MaskSubView sub = view;
+
+        sub.x_begin = view.x_begin + range.x_begin;
+        sub.y_begin = view.y_begin + range.y_begin;
+        sub.width = range.x_end - range.x_begin;
+        sub.height = range.y_end - range.y_begin;
+
+        return sub;
     }
 
 
-    static Span32 to_span(BackgroundView const& view)
+    // first word of the row, not the word at x_begin
+    static u64* row_words_begin(MaskSubView const& view, u32 y)
     {
-        auto length = view.dims.proc.width * view.dims.proc.height;
-        return span::make_view(view.data, length);
+        return view.matrix_data_ + (u64)(view.y_begin + y) * view.matrix_width;
     }
+}
+
 
+/* background mask view */
 
-    static ImageView to_image_view(BackgroundView const& view)
+namespace game_punk
+{
+    class BackgroundMaskView
     {
-        auto dims = view.dims.proc;
-        return img::make_view(dims.width, dims.height, view.data);
+    public:
+        static constexpr auto dims = BACKGROUND_DIMS;
+
+        u64* data = 0;
+    };
+
+
+    static u32 row_words(BackgroundMaskView const& view)
+    {
+        return mask_row_words(view.dims.proc.width);
     }
 
 
-    static void copy(BackgroundView const& src, BackgroundView const& dst)
+    static void count_view(BackgroundMaskView& view, MemoryCounts& counts)
     {
-        copy(to_span_cx(src), to_span_cx(dst));
+        auto length = row_words(view) * view.dims.proc.height;
+        add_count<u64>(counts, length);
+        view.data = 0;
+    }
+
+
+    static bool create_view(BackgroundMaskView& view, Memory& memory)
+    {
+        auto length = row_words(view) * view.dims.proc.height;
+
+        auto res = push_mem<u64>(memory, length);
+        if (res.ok)
+        {
+            view.data = res.data;
+        }
+
+        return res.ok;
     }
 
+
+    static void pack_mask(Span8 const& filter, BackgroundMaskView const& mask)
+    {
+        auto W = mask.dims.proc.width;
+        auto H = mask.dims.proc.height;
+        auto RW = row_words(mask);
+
+        app_assert(filter.length == W * H);
+
+        for (u32 y = 0; y < H; y++)
+        {
+            auto s = filter.data + y * W;
+            auto d = mask.data + y * RW;
+
+            for (u32 w = 0; w < RW; w++)
+            {
+                auto x_begin = w * 64;
+                auto x_end = math::min(x_begin + 64, W);
+
+                u64 bits = 0;
+                for (u32 x = x_begin; x < x_end; x++)
+                {
+                    // only Primary (255) is visible
+                    bits |= (u64)(s[x] == 255) << (x - x_begin);
+                }
+
+                d[w] = bits;
+            }
+        }
+    }
 }
 
 
-/* background filter view */
+/* color palette */
 
 namespace game_punk
 {
-    class BackgroundFilterView
+    // colors for a u8 index plane
+    class ColorPalette
     {
     public:
-        static constexpr auto dims = BACKGROUND_DIMS;
+        static constexpr u32 count = 256;
 
-        u8* data = 0;
+        p32* data = 0;
     };
 
 
-    static void count_view(BackgroundFilterView& view, MemoryCounts& counts)
+    static void count_view(ColorPalette& palette, MemoryCounts& counts)
     {
-        auto length = view.dims.proc.width * view.dims.proc.height;
-        add_count<u8>(counts, length);
-        view.data = 0;
+        add_count<p32>(counts, palette.count);
+        palette.data = 0;
     }
 
 
-    static bool create_view(BackgroundFilterView& view, Memory& memory)
+    static bool create_view(ColorPalette& palette, Memory& memory)
     {
-        auto length = view.dims.proc.width * view.dims.proc.height;
-
-        auto res = push_mem<u8>(memory, length);
+        auto res = push_mem<p32>(memory, palette.count);
         if (res.ok)
         {
-            view.data = res.data;
+            palette.data = res.data;
         }
 
         return res.ok;
     }
 
 
-    static SpanView<u8> to_span(BackgroundFilterView const& filter)
+    static Opacity get_opacity(SpanView<u8> const& index, ColorPalette const& palette)
     {
-        auto dims = filter.dims.proc;
+        u32 n_opaque = 0;
+        u32 n_transparent = 0;
 
-        SpanView<u8> view;
-        view.data = filter.data;
-        view.length = dims.width * dims.height;
+        auto p = palette.data;
 
-        return view;
+        for (u32 i = 0; i < index.length; i++)
+        {
+            auto a = p[index.data[i]].alpha;
+            n_opaque += a == 255;
+            n_transparent += a == 0;
+        }
+
+        return get_opacity(n_opaque, n_transparent, index.length);
     }
 }
 
@@ -206,14 +302,15 @@ namespace game_punk
         static constexpr u32 width = cxpr::SKY_OVERLAY_WIDTH_PX;
         static constexpr u32 height = cxpr::SKY_OVERLAY_HEIGHT_PX;
 
-        p32* data = 0;
+        // index into SkyAnimation::palette
+        u8* data = 0;
     };
 
 
     static void count_view(SkyOverlayView& view, MemoryCounts& counts)
     {
         auto length = view.width * view.height;
-        add_count<p32>(counts, length);
+        add_count<u8>(counts, length);
     }
 
 
@@ -227,7 +324,7 @@ namespace game_punk
 
         auto length = view.width * view.height;
 
-        auto res = push_mem<p32>(memory, length);
+        auto res = push_mem<u8>(memory, length);
         if (res.ok)
         {
             view.data = res.data;
@@ -236,16 +333,8 @@ namespace game_punk
         return res.ok;
     }
 
-
-    static auto to_span_cx(SkyOverlayView const& view)
-    {
-        constexpr auto W = cxpr::SKY_OVERLAY_WIDTH_PX;
-        constexpr auto H = cxpr::SKY_OVERLAY_HEIGHT_PX;
-        return Span32_cxpr<W, H>(view.data);
-    }
-
     
-    static Span32 to_span(SkyOverlayView const& view)
+    static SpanView<u8> to_span(SkyOverlayView const& view)
     {
         auto length = view.width * view.height;
 
@@ -253,23 +342,23 @@ namespace game_punk
     }
 
 
-    static ImageView to_image_view(SkyOverlayView const& view)
+    static GrayView to_gray_view(SkyOverlayView const& view)
     {
         return img::make_view(view.width, view.height, view.data);
     }
 
 
-    static SubView sub_view(SkyOverlayView const& view, Vec2Di32 pos)
+    static GraySubView sub_view(SkyOverlayView const& view, Vec2Di32 pos)
     {
         auto x = (u32)pos.x;
         auto y = (u32)pos.y;
         auto w = BACKGROUND_DIMS.proc.width;
         auto h = BACKGROUND_DIMS.proc.height;
-        return img::sub_view(to_image_view(view), img::make_rect(x, y, w, h));
+        return img::sub_view(to_gray_view(view), img::make_rect(x, y, w, h));
     }
 
 
-    static SubView sub_view(SkyOverlayView const& view, ScenePosition pos)
+    static GraySubView sub_view(SkyOverlayView const& view, ScenePosition pos)
     {
         Vec2Di32 p = {
             pos.proc.x.get(),
@@ -294,6 +383,8 @@ namespace game_punk
 
         ContextDims bitmap_dims;
         u32 bitmap_count = 0;
+
+        AlphaRuns runs;
     };
 
 
@@ -327,6 +418,7 @@ namespace game_punk
         auto length = ctx.width * ctx.height;
 
         add_count<p32>(counts, length);
+        count_runs(counts, ctx.width, ctx.height);
     }
 
 
@@ -348,7 +440,7 @@ namespace game_punk
             view.data = res.data;
         }
 
-        return res.ok;
+        return res.ok && create_runs(view.runs, memory, ctx.width, ctx.height);
     }
 
 
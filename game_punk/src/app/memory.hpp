@@ -5,69 +5,76 @@
 
 namespace game_punk
 {
+    // every allocation begins on a cache line, SIMD kernels can use aligned loads
+    constexpr u32 MEMORY_ALIGN = 64;
+
+
+    static constexpr u32 align_bytes(u32 n_bytes)
+    {
+        return (n_bytes + MEMORY_ALIGN - 1) & ~(MEMORY_ALIGN - 1);
+    }
+
 
     class MemoryCounts
     {
     public:
-        u32 count_8 = 0;
-        u32 count_16 = 0;
-        u32 count_32 = 0;
-        u32 count_64 = 0;
+        // bytes, each allocation rounded up to MEMORY_ALIGN
+        u32 n_bytes = 0;
+
+        // reset every frame
+        u32 n_scratch_bytes = 0;
     };
 
 
+    // n_arrays separate allocations of n elements
     template <typename T>
-    void add_count(MemoryCounts& mc, u32 n)
+    void add_count(MemoryCounts& mc, u32 n, u32 n_arrays = 1)
     {
-        constexpr auto s8 = sizeof(u8);
-        constexpr auto s16 = sizeof(u16);
-        constexpr auto s32 = sizeof(u32);
-        constexpr auto s64 = sizeof(u64);
+        static_assert(alignof(T) <= MEMORY_ALIGN);
 
-        auto s = sizeof(T);
+        mc.n_bytes += n_arrays * align_bytes(n * (u32)sizeof(T));
+    }
 
-        if (s % s64 == 0)
-        {
-            n *= s / s64;
-            mc.count_64 += n;
-        }
-        else if (s % s32 == 0)
-        {
-            n *= s / s32;
-            mc.count_32 += n;
-        }
-        else if (s % s16 == 0)
-        {
-            n *= s / s16;
-            mc.count_16 += n;
-        }
-        else
-        {
-            n *= s / s8;
-            mc.count_8 += n;
-        }        
+
+    template <typename T>
+    void add_scratch_count(MemoryCounts& mc, u32 n)
+    {
+        static_assert(alignof(T) <= MEMORY_ALIGN);
+
+        mc.n_scratch_bytes += align_bytes(n * (u32)sizeof(T));
     }
 
 
+    // one arena, game lifetime allocations then the per frame scratch region
     class Memory
     {
     public:
         bool ok = 0;
 
-        Buffer8 mem_8;
-        Buffer16 mem_16;
-        Buffer32 mem_32;
-        Buffer64 mem_64;
+        // unaligned allocation
+        Buffer8 buffer;
+
+        // MEMORY_ALIGN aligned
+        u8* data = 0;
+        u32 capacity = 0;
+
+        u32 size = 0;
+
+        // [scratch_begin, capacity)
+        u32 scratch_begin = 0;
+        u32 scratch_size = 0;
+
+        // largest scratch_size since create_memory
+        u32 scratch_high = 0;
     };
 
 
     static void destroy_memory(Memory& mem)
     {
-        mb::destroy_buffer(mem.mem_8);
-        mb::destroy_buffer(mem.mem_16);
-        mb::destroy_buffer(mem.mem_32);
-        mb::destroy_buffer(mem.mem_64);
+        mb::destroy_buffer(mem.buffer);
 
+        mem.data = 0;
+        mem.capacity = 0;
         mem.ok = false;
     }
 
@@ -77,31 +84,29 @@ namespace game_punk
         Memory mem{};
         mem.ok = false;
 
-        bool ok = true;
-
-        auto create = [&](auto& buffer, auto& count, cstr tag) 
-        { 
-            if (count)
-            {
-                ok &= mb::create_buffer(buffer, count, tag); 
-            }
-
-            if (count && ok)
-            {
-                mb::zero_buffer(buffer);
-            }
-        };
-
-        create(mem.mem_8, counts.count_8, "8");
-        create(mem.mem_16, counts.count_16, "16");
-        create(mem.mem_32, counts.count_32, "32");
-        create(mem.mem_64, counts.count_64, "64");
+        auto capacity = counts.n_bytes + counts.n_scratch_bytes;
+        if (!capacity)
+        {
+            return mem;
+        }
 
-        if (!ok)
+        if (!mb::create_buffer(mem.buffer, capacity + MEMORY_ALIGN - 1, "memory"))
         {
             destroy_memory(mem);
             return mem;
         }
+
+        mb::zero_buffer(mem.buffer);
+
+        auto address = (uintptr_t)mem.buffer.data_;
+        auto offset = (u32)((MEMORY_ALIGN - address % MEMORY_ALIGN) % MEMORY_ALIGN);
+
+        mem.data = mem.buffer.data_ + offset;
+        mem.capacity = capacity;
+        mem.size = 0;
+        mem.scratch_begin = counts.n_bytes;
+        mem.scratch_size = 0;
+        mem.scratch_high = 0;
         
         mem.ok = true;
 
@@ -115,138 +120,70 @@ namespace game_punk
         Result<T*> res{};
         res.ok = false;
 
-        constexpr auto s8 = sizeof(u8);
-        constexpr auto s16 = sizeof(u16);
-        constexpr auto s32 = sizeof(u32);
-        constexpr auto s64 = sizeof(u64);
-
-        auto s = sizeof(T);
-        auto n = n_elements;
+        auto n_bytes = align_bytes(n_elements * (u32)sizeof(T));
 
-        if (s % s64 == 0)
-        {
-            n *= s / s64;
-            res.data = (T*)mb::push_elements(mem.mem_64, n);
-        }
-        else if (s % s32 == 0)
-        {
-            n *= s / s32;
-            res.data = (T*)mb::push_elements(mem.mem_32, n);
-        }
-        else if (s % s16 == 0)
-        {
-            n *= s / s16;
-           res.data = (T*)mb::push_elements(mem.mem_16, n);
-        }
-        else
-        {
-            n *= s / s8;
-            res.data = (T*)mb::push_elements(mem.mem_8, n);
-        }
+        bool ok = n_bytes && mem.size + n_bytes <= mem.scratch_begin;
+        app_assert(ok && "*** Memory not counted ***");
 
-        if (res.data)
+        if (ok)
         {
+            res.data = (T*)(mem.data + mem.size);
             res.ok = true;
+            mem.size += n_bytes;
         }
 
         return res;
     }
 
 
-    static void log_mem(Memory const& mem, MemoryCounts const& mc)
-    {
-        auto const write = [](cstr name, auto const& mem, u32 count)
-        {
-            app_log("%s(%u): %u / %u / %u\n", name, (u32)sizeof(mem.data_[0]), mem.size_, mem.capacity_, count); 
-        };
-
-        app_log("\n");
-        write("   8", mem.mem_8, mc.count_8);
-        write("  16", mem.mem_16, mc.count_16);
-        write("  32", mem.mem_32, mc.count_32);
-        write("  64", mem.mem_64, mc.count_64);
-        app_log("\n");
-    }
-
-
-    static bool verify_allocated(Memory const& memory)
+    // valid until reset_scratch, contents are not cleared
+    template <typename T>
+    static Result<T*> push_scratch(Memory& mem, u32 n_elements)
     {
-        bool ok = true;
-
-        auto is_ok = [](auto const& buffer) { return buffer.size_ == buffer.capacity_; };
-        
-        ok &= is_ok(memory.mem_8);
-        app_assert(ok && "*** 8 bit Memory not allocated ***");
+        Result<T*> res{};
+        res.ok = false;
 
-        ok &= is_ok(memory.mem_16);
-        app_assert(ok && "*** 16 bit Memory not allocated ***");
+        auto n_bytes = align_bytes(n_elements * (u32)sizeof(T));
+        auto begin = mem.scratch_begin + mem.scratch_size;
 
-        ok &= is_ok(memory.mem_32);
-        app_assert(ok && "*** 32 bit Memory not allocated ***");
+        bool ok = n_bytes && begin + n_bytes <= mem.capacity;
+        app_assert(ok && "*** Scratch memory not counted ***");
 
-        ok &= is_ok(memory.mem_64);        
-        app_assert(ok && "*** 64 bit Memory not allocated ***");
+        if (ok)
+        {
+            res.data = (T*)(mem.data + begin);
+            res.ok = true;
+            mem.scratch_size += n_bytes;
+            mem.scratch_high = math::max(mem.scratch_high, mem.scratch_size);
+        }
 
-        return ok;
+        return res;
     }
-    
-}
-
 
-/* memory stack */
 
-namespace game_punk
-{
-    template <typename T>
-    class MemoryStack
+    static void reset_scratch(Memory& mem)
     {
-    public:
-        T* data_ = 0;
-        u32 capacity_ = 0;
-
-        u32 size = 0;        
-    };
+        mem.scratch_size = 0;
+    }
 
 
-    template <typename T>
-    inline void reset_stack(MemoryStack<T>& stack)
+    static void log_mem(Memory const& mem)
     {
-        stack.size = 0;
+        app_log("\n");
+        app_log("memory:  %u / %u\n", mem.size, mem.scratch_begin);
+        app_log("scratch: %u / %u, high %u\n", mem.scratch_size, mem.capacity - mem.scratch_begin, mem.scratch_high);
+        app_log("\n");
     }
 
 
-    template <typename T>
-    inline T* push_elements(MemoryStack<T>& stack, u32 n_elements)
+    static bool verify_allocated(Memory const& memory)
     {
-        app_assert(n_elements);
-
-		if (n_elements == 0)
-		{
-			return 0;
-		}
-        
-		app_assert(stack.capacity_);
-
-		auto is_valid =
-			stack.capacity_ &&
-			stack.size < stack.capacity_;
-        
-        app_assert(is_valid);
-
-		auto elements_available = (stack.capacity_ - stack.size) >= n_elements;
-		app_assert(elements_available);
-
-		if (!is_valid || !elements_available)
-		{
-			return 0;
-		}
-
-		auto data = stack.data_ + stack.size;
+        bool ok = memory.ok && memory.size == memory.scratch_begin;
+        app_assert(ok && "*** Memory not allocated ***");
 
-		stack.size += n_elements;
-
-		return data;
+        return ok;
     }
+    
 }
 
 
@@ -308,45 +245,4 @@ namespace game_punk
 
         return res.ok;
     }
-
-
-    template <typename T>
-    static void count_stack(MemoryStack<T>& stack, MemoryCounts& counts, u32 n_elements)
-    {
-        stack.capacity_ = n_elements;
-        stack.size = 0;
-
-        add_count<T>(counts, n_elements);
-    }
-
-
-    template <typename T>
-    static bool create_stack(MemoryStack<T>& stack, Memory& memory)
-    {
-        if (!stack.capacity_)
-        {
-            app_crash("*** MemoryStack not initialized ***");
-            return false;
-        }
-
-        auto res = push_mem<T>(memory, stack.capacity_);
-        if (res.ok)
-        {
-            stack.data_ = res.data;
-        }
-
-        return res.ok;
-    }
-
-
-    template <typename T>
-    inline SpanView<T> to_span(MemoryStack<T> const& stack)
-    {
-        SpanView<T> view;
-        view.data = stack.data_;
-        view.length = stack.capacity_;
-
-        return view;
-    }
-    
 }
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "../../../libs/datetime/datetime.hpp"
+
+
+#ifndef GAME_PUNK_RELEASE
+#define GAME_PUNK_PROFILE
+#endif
+
+
+#ifdef GAME_PUNK_PROFILE
+
+#include <cstdio>
+
+
+/* profile zones */
+
+namespace game_punk
+{
+namespace profile
+{
+    enum class ZoneId : u8
+    {
+        MapInput = 0,
+        MoveSprites,
+        UpdateTiles,
+        AnimateSprites,
+        DrawBackground,
+        Draw,
+        LoadAll,
+        WindowRender,
+
+        Count
+    };
+
+
+    constexpr u32 ZONE_COUNT = (u32)ZoneId::Count;
+
+
+    constexpr cstr ZONE_NAMES[ZONE_COUNT] = {
+        "map_input",
+        "move_sprites_xy",
+        "update_tiles",
+        "animate_sprites",
+        "draw_background",
+        "draw",
+        "load_all",
+        "window::render",
+    };
+
+
+    class ZoneRecord
+    {
+    public:
+        u64 begin_ns = 0;
+        u32 duration_ns = 0;
+        u32 frame = 0;
+        ZoneId zone = ZoneId::Count;
+    };
+
+
+    class ProfileRing
+    {
+    public:
+        static constexpr u32 capacity = 8192;
+
+        ZoneRecord records[capacity];
+
+        u64 write = 0;
+        u32 frame = 0;
+
+        u64 origin_ns = 0;
+
+        // most recent completed frame
+        u32 frame_ns[ZONE_COUNT] = { 0 };
+        u32 acc_ns[ZONE_COUNT] = { 0 };
+    };
+
+
+    static_assert((ProfileRing::capacity & (ProfileRing::capacity - 1)) == 0);
+
+
+    inline ProfileRing ring;
+
+
+    inline void begin_frame()
+    {
+        auto& r = ring;
+
+        if (!r.origin_ns)
+        {
+            r.origin_ns = datetime::query_nanoseconds_u64();
+        }
+
+        for (u32 i = 0; i < ZONE_COUNT; i++)
+        {
+            r.frame_ns[i] = r.acc_ns[i];
+            r.acc_ns[i] = 0;
+        }
+
+        ++r.frame;
+    }
+
+
+    inline void add_zone(ZoneId zone, u64 begin_ns, u64 end_ns)
+    {
+        auto& r = ring;
+
+        auto& rec = r.records[r.write & (r.capacity - 1)];
+        ++r.write;
+
+        rec.begin_ns = begin_ns;
+        rec.duration_ns = (u32)(end_ns - begin_ns);
+        rec.frame = r.frame;
+        rec.zone = zone;
+
+        r.acc_ns[(u32)zone] += rec.duration_ns;
+    }
+
+
+    inline f32 last_frame_ms(ZoneId zone)
+    {
+        return ring.frame_ns[(u32)zone] / 1'000'000.0f;
+    }
+
+
+    class ScopedZone
+    {
+    private:
+        u64 begin_ns;
+        ZoneId zone;
+
+    public:
+        ScopedZone(ZoneId id)
+        {
+            zone = id;
+            begin_ns = datetime::query_nanoseconds_u64();
+        }
+
+        ~ScopedZone()
+        {
+            add_zone(zone, begin_ns, datetime::query_nanoseconds_u64());
+        }
+    };
+
+
+    // Chrome about:tracing / Perfetto "Trace Event" JSON
+    inline bool dump_trace(cstr path)
+    {
+        auto& r = ring;
+
+        auto file = std::fopen(path, "w");
+        if (!file)
+        {
+            return false;
+        }
+
+        auto count = r.write < r.capacity ? r.write : (u64)r.capacity;
+        auto begin = r.write - count;
+
+        std::fprintf(file, "{\"traceEvents\":[\n");
+
+        for (u64 i = 0; i < count; i++)
+        {
+            auto& rec = r.records[(begin + i) & (r.capacity - 1)];
+
+            auto ts = (f64)(rec.begin_ns - r.origin_ns) / 1000.0;
+            auto dur = (f64)rec.duration_ns / 1000.0;
+            auto sep = i + 1 < count ? "," : "";
+
+            std::fprintf(file,
+                "{\"name\":\"%s\",\"cat\":\"game\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"frame\":%u}}%s\n",
+                ZONE_NAMES[(u32)rec.zone], ts, dur, rec.frame, sep);
+        }
+
+        std::fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+        std::fclose(file);
+
+        return true;
+    }
+}
+}
+
+
+#define PROFILE_FRAME() game_punk::profile::begin_frame()
+#define PROFILE_ZONE(id) game_punk::profile::ScopedZone profile_zone_(game_punk::profile::ZoneId::id)
+
+#else
+
+#define PROFILE_FRAME()
+#define PROFILE_ZONE(id)
+
+#endif
@@ -9,26 +9,20 @@ namespace game_punk
     {
     public:
         SkyOverlayView overlay_src;
+        ColorPalette palette;
 
         ScenePosition ov_pos;
         Vec2Di32 ov_vel;
 
-        BackgroundView out[2];
-        u8 out_id = 0;
-
-        BackgroundView& out_front() { return out[out_id]; }
-
-        BackgroundView& out_back() { return out[!out_id]; }
-
-        void out_swap() { out_id = !out_id; }
+        Opacity opacity = Opacity::Mixed;
+        u32 version = 0;
     };
 
 
     static void count_sky_animation(SkyAnimation& sky, MemoryCounts& counts)
     {
         count_view(sky.overlay_src, counts);
-        count_view(sky.out[0], counts);
-        count_view(sky.out[1], counts);
+        count_view(sky.palette, counts);
     }
 
 
@@ -37,21 +31,10 @@ namespace game_punk
         bool ok = true;
         
         ok &= create_view(sky.overlay_src, memory);
-        ok &= create_view(sky.out[0], memory);
-        ok &= create_view(sky.out[1], memory);
+        ok &= create_view(sky.palette, memory);
 
         return ok;
     }
-    
-
-    static void render_front_back(SkyAnimation& sky)
-    {
-        auto front = to_span_cx(sky.out_front());
-        auto back = to_span_cx(sky.out_back());
-
-        img::copy(sub_view(sky.overlay_src, sky.ov_pos), to_image_view(sky.out_front()));
-        copy(front, back);
-    }
 
 
     static void reset_sky_animation(SkyAnimation& sky)
@@ -62,20 +45,18 @@ namespace game_punk
 
         bool ok = true;
         ok &= has_data(sky.overlay_src);
-        ok &= has_data(sky.out[0]);
-        ok &= has_data(sky.out[1]);
+        ok &= has_data(sky.palette);
 
         app_assert(ok && "*** SkyAnimation not created ***");
 
-        render_front_back(sky);
+        sky.version++;
     }
 
 
     static void update_overlay_position(SkyAnimation& sky)
     {
-        auto ov = to_image_view(sky.out_back());
-        auto w = ov.width;
-        auto h = ov.height;
+        auto w = BACKGROUND_DIMS.proc.width;
+        auto h = BACKGROUND_DIMS.proc.height;
 
         auto& data_ov = sky.overlay_src;
 
@@ -106,21 +87,21 @@ namespace game_punk
             pos.y = units::SceneDimension::make(y);
         }
 
-        img::copy(sub_view(data_ov, sky.ov_pos), ov);
+        sky.version++;
     }
     
     
-    static BackgroundView get_sky_animation(SkyAnimation& sky, GameTick64 game_tick)
+    // drawn straight from the overlay at the current scroll position
+    static GraySubView get_sky_animation(SkyAnimation& sky, GameTick64 game_tick)
     {
         constexpr u32 frame_wait = 6;
 
         if (game_tick.value_ % frame_wait == 0)
         {
             update_overlay_position(sky);
-            sky.out_swap();
         }
 
-        return sky.out_front();
+        return sub_view(sky.overlay_src, sky.ov_pos);
     }
     
 }
@@ -137,29 +118,38 @@ namespace game_punk
         u32 height1 = 0;
         u32 height2 = 0;
 
-        p32* data1 = 0;
-        p32* data2 = 0;
+        u64* data1 = 0;
+        u64* data2 = 0;
+
+        p32 color;
+
+        Opacity opacity1 = Opacity::Mixed;
+        Opacity opacity2 = Opacity::Mixed;
+
+        u32 version = 0;
     };
 
 
-    static ImageView to_image_view_first(BackgroundPartPair const& bp)
+    static MaskView to_mask_view_first(BackgroundPartPair const& bp)
     {
-        ImageView view;
+        MaskView view;
 
         view.width = BACKGROUND_DIMS.proc.width;
         view.height = bp.height1;
+        view.matrix_width = mask_row_words(view.width);
         view.matrix_data_ = bp.data1;
 
         return view;
     }
 
 
-    static ImageView to_image_view_second(BackgroundPartPair const& bp)
+    static MaskView to_mask_view_second(BackgroundPartPair const& bp)
     {
-        ImageView view;
+        MaskView view;
 
         view.width = BACKGROUND_DIMS.proc.width;
         view.height = bp.height2;
+        view.matrix_width = mask_row_words(view.width);
         view.matrix_data_ = bp.data2;
 
         return view;
@@ -170,11 +160,16 @@ namespace game_punk
     {
     public:
 
-        using FilterTable = ObjectTable<BackgroundFilterView>;
+        using FilterTable = ObjectTable<BackgroundMaskView>;
         using AssetID = FilterTable::ID;
 
+        // set bits are drawn with primary_color
         FilterTable background_filters;
-        BackgroundView background_data[2] = { 0 };
+
+        AssetID data_ids[2] = { 0 };
+
+        Opacity filter_opacity[cxpr::BACKGROUND_COUNT_MAX] = { Opacity::Mixed };
+        Opacity data_opacity[2] = { Opacity::Mixed };
         
         u32 speed_shift = 0;
         p32 primary_color;
@@ -182,23 +177,63 @@ namespace game_punk
         u64 load_pos = 0;
         AssetID current_background;
 
+        u32 version = 0;
+
         RingStackBuffer<AssetID, 4> work_asset_ids;
         RandomStackBuffer<AssetID, cxpr::BACKGROUND_COUNT_MAX - 4> select_asset_ids;
     };
 
 
+    static Opacity get_filter_opacity(BackgroundMaskView const& filter)
+    {
+        // set bits are drawn opaque, padding bits are zero
+        auto W = filter.dims.proc.width;
+        auto H = filter.dims.proc.height;
+        auto length = row_words(filter) * H;
+
+        u32 n_primary = 0;
+
+        for (u32 i = 0; i < length; i++)
+        {
+            n_primary += (u32)std::popcount(filter.data[i]);
+        }
+
+        return get_opacity(n_primary, W * H - n_primary, W * H);
+    }
+
+
+    static void set_primary_color(BackgroundAnimation& an, p32 color)
+    {
+        color.alpha = 255; // no transparency allowed
+
+        an.primary_color = color;
+    }
+
+
     static void reset_background_animation(BackgroundAnimation& an)
     {
         using AssetID = BackgroundAnimation::AssetID;
 
         bool ok = true;
-        ok &= has_data(an.background_data[0]);
-        ok &= has_data(an.background_data[1]);
+        ok &= has_data(an.background_filters);
 
         app_assert(ok && "*** BackgroundAnimation not created ***");
 
         an.speed_shift = 0;
         an.load_pos = 0;
+        an.current_background = { 0 };
+
+        // same initial backgrounds as init_load_background
+        constexpr auto N = sizeof(an.data_ids) / sizeof(an.data_ids[0]);
+
+        for (u32 i = 0; i < N; i++)
+        {
+            an.data_ids[i] = { (u16)i };
+            an.data_opacity[i] = an.filter_opacity[i];
+        }
+
+        // cached draws of the old filters are stale
+        an.version++;
 
         auto WC = an.work_asset_ids.count;
         auto SC = an.select_asset_ids.capacity;
@@ -219,11 +254,9 @@ namespace game_punk
 
     static void count_background_animation(BackgroundAnimation& an, MemoryCounts& counts, u32 n_backgrounds)
     {
-        count_view(an.background_data[0], counts);
-        count_view(an.background_data[1], counts);
         count_table(an.background_filters, counts, n_backgrounds);
 
-        BackgroundFilterView filter;
+        BackgroundMaskView filter;
         for (u32 i = 0; i < n_backgrounds; i++)
         {
             count_view(filter, counts);
@@ -235,9 +268,6 @@ namespace game_punk
     {
         bool ok = true;
 
-        ok &= create_view(an.background_data[0], memory);
-        ok &= create_view(an.background_data[1], memory);
-
         auto& filters = an.background_filters;
 
         ok &= create_table(filters, memory);
@@ -251,13 +281,11 @@ namespace game_punk
     }
 
 
-    static BackgroundPartPair get_animation_pair(BackgroundAnimation& an, Randomf32& rng, u64 pos)
+    static BackgroundPartPair get_animation_pair(BackgroundAnimation& an, Random32& rng, u64 pos)
     {
-        using AssetID = BackgroundAnimation::AssetID;
-
         BackgroundPartPair bp;
 
-        auto W = BACKGROUND_DIMS.proc.width;
+        auto RW = mask_row_words(BACKGROUND_DIMS.proc.width);
         auto H = BACKGROUND_DIMS.proc.height;
 
         auto p = pos >> an.speed_shift; // speed
@@ -271,9 +299,6 @@ namespace game_punk
         bp.height2 = p;
         bp.height1 = H - bp.height2;
 
-        bp.data1 = an.background_data[data_1].data + bp.height2 * W;
-        bp.data2 = an.background_data[data_2].data;
-
         if (bp.height2 == 0 && pos != an.load_pos)
         { 
             an.load_pos = pos;
@@ -287,11 +312,22 @@ namespace game_punk
             work_id = an.current_background;
             an.work_asset_ids.next();
 
-            auto src = to_span(an.background_filters.item_at(an.current_background));
-            auto dst = to_span(an.background_data[data_2]);
-            bt::alpha_filter_convert(src, dst, an.primary_color);
+            // hidden part shows the new filter
+            an.data_ids[data_2] = an.current_background;
+            an.data_opacity[data_2] = an.filter_opacity[an.current_background.value_];
+            an.version++;
         }
 
+        auto& filters = an.background_filters;
+
+        bp.data1 = filters.item_at(an.data_ids[data_1]).data + bp.height2 * RW;
+        bp.data2 = filters.item_at(an.data_ids[data_2]).data;
+        bp.color = an.primary_color;
+
+        bp.opacity1 = an.data_opacity[data_1];
+        bp.opacity2 = an.data_opacity[data_2];
+        bp.version = an.version;
+
         return bp;
     }
 }
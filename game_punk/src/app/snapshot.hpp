@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstring>
+
+
+/* snapshot ring */
+
+namespace game_punk
+{
+    // mutable game state saved once per frame, oldest snapshots are overwritten
+    class SnapshotRing
+    {
+    public:
+        // 2 seconds at 60 fps
+        static constexpr u32 count = 120;
+
+        // rounded up to whole cache lines
+        u32 slot_bytes = 0;
+
+        u64* data = 0;
+
+        // next slot written
+        u32 write = 0;
+        u32 n_saved = 0;
+    };
+
+
+    class SnapshotCursor
+    {
+    public:
+        u8* slot = 0;
+        u32 offset = 0;
+    };
+
+
+    static void reset_snapshot_ring(SnapshotRing& ring)
+    {
+        ring.write = 0;
+        ring.n_saved = 0;
+    }
+
+
+    static void count_snapshot_ring(SnapshotRing& ring, MemoryCounts& counts, u32 n_bytes)
+    {
+        ring.slot_bytes = align_bytes(n_bytes);
+
+        add_count<u64>(counts, ring.count * ring.slot_bytes / 8);
+    }
+
+
+    static bool create_snapshot_ring(SnapshotRing& ring, Memory& memory)
+    {
+        if (!ring.slot_bytes)
+        {
+            app_crash("*** SnapshotRing not initialized ***");
+            return false;
+        }
+
+        auto res = push_mem<u64>(memory, ring.count * ring.slot_bytes / 8);
+        if (res.ok)
+        {
+            ring.data = res.data;
+        }
+
+        reset_snapshot_ring(ring);
+
+        return res.ok;
+    }
+
+
+    static u8* slot_at(SnapshotRing const& ring, u32 slot)
+    {
+        return (u8*)ring.data + (u64)slot * ring.slot_bytes;
+    }
+
+
+    // slot for the next save, overwrites the oldest when full
+    static u8* push_slot(SnapshotRing& ring)
+    {
+        auto slot = slot_at(ring, ring.write);
+
+        ring.write = (ring.write + 1) % ring.count;
+        ring.n_saved += ring.n_saved < ring.count;
+
+        return slot;
+    }
+
+
+    // n_back = 0 is the most recent save, later saves are dropped
+    static u8* pop_slot(SnapshotRing& ring, u32 n_back)
+    {
+        if (n_back >= ring.n_saved)
+        {
+            return 0;
+        }
+
+        auto s = (ring.write + ring.count - 1 - n_back) % ring.count;
+
+        ring.write = (s + 1) % ring.count;
+        ring.n_saved -= n_back;
+
+        return slot_at(ring, s);
+    }
+
+
+    static void save_bytes(SnapshotCursor& dst, void const* src, u32 n_bytes)
+    {
+        std::memcpy(dst.slot + dst.offset, src, n_bytes);
+        dst.offset += n_bytes;
+    }
+
+
+    static void load_bytes(SnapshotCursor& src, void* dst, u32 n_bytes)
+    {
+        std::memcpy(dst, src.slot + src.offset, n_bytes);
+        src.offset += n_bytes;
+    }
+}
@@ -81,7 +81,7 @@ namespace game_punk
 
     static TileAcc accelerate_stop(TileSpeed speed)
     {
-        auto delta = TileValue::make(-speed.get());
+        auto delta = TileValue::make(-speed.value_.value_);
 
         return TileAcc::make(delta);
     }
@@ -109,20 +109,22 @@ namespace game_punk
 
     static TileAcc accelerate_punk_idle_x(TileSpeed speed, TickQty32 time)
     {
-        constexpr auto min_speed = TileValue::min_value() * 100;
+        constexpr i32 min_speed = 100;
         constexpr auto zero = TileAcc::zero();
 
-        if (speed == TileSpeed::zero())
+        auto v = speed.value_.value_;
+
+        if (v == 0)
         {
             return zero;
         }
 
-        if (math::abs(speed.get()) <= min_speed)
+        if (math::abs(v) <= min_speed)
         {
             return accelerate_stop(speed);
         }
 
-        auto delta = TileValue::make(-speed.get() / 8);
+        auto delta = TileValue::make(-v / 8);
 
         return TileAcc::make(delta);
     }
@@ -164,25 +166,44 @@ namespace game_punk
 }
 
 
+/* acceleration group */
+
+namespace game_punk
+{
+    // one call per (name, mode) group, the rule is inlined into the loop
+    using AccelerateGroupFn = void (*)(TileAcc* acc, TileSpeed const* vel, GameTick64 const* beg, u32 count, GameTick64 tick);
+
+
+    template <AccelerateFn FN>
+    static void accelerate_group(TileAcc* acc, TileSpeed const* vel, GameTick64 const* beg, u32 count, GameTick64 tick)
+    {
+        for (u32 i = 0; i < count; i++)
+        {
+            acc[i] = FN(vel[i], tick - beg[i]);
+        }
+    }
+}
+
+
 /* acceleration x */
 
 namespace game_punk
 {
-    static AccelerateFn get_punk_accelerate_x_fn(SpriteMode mode)
+    static AccelerateGroupFn get_punk_accelerate_x_fn(SpriteMode mode)
     {
         using Mode = SpriteMode;
 
         switch (mode)
         {
-        case Mode::Idle: return accelerate_punk_idle_x;
-        case Mode::Run: return accelerate_punk_run_x;
+        case Mode::Idle: return accelerate_group<accelerate_punk_idle_x>;
+        case Mode::Run: return accelerate_group<accelerate_punk_run_x>;
 
-        default: return accelerate_zero;
+        default: return accelerate_group<accelerate_zero>;
         }
     }
 
 
-    static AccelerateFn get_accelerate_x_fn(SpriteName sprite, SpriteMode mode)
+    static AccelerateGroupFn get_accelerate_x_fn(SpriteName sprite, SpriteMode mode)
     {
         using Sprite = SpriteName;
         using Mode = SpriteMode;
@@ -191,7 +212,7 @@ namespace game_punk
         {
         case Sprite::Punk: return get_punk_accelerate_x_fn(mode);
 
-        default: return accelerate_zero;
+        default: return accelerate_group<accelerate_zero>;
         }
     }
 }
@@ -201,20 +222,20 @@ namespace game_punk
 
 namespace game_punk
 {
-    static AccelerateFn get_punk_accelerate_y_fn(SpriteMode mode)
+    static AccelerateGroupFn get_punk_accelerate_y_fn(SpriteMode mode)
     {
         using Mode = SpriteMode;
 
         switch (mode)
         {
-        case Mode::Jump: return accelerate_punk_jump_y;
+        case Mode::Jump: return accelerate_group<accelerate_punk_jump_y>;
 
-        default: return accelerate_zero;
+        default: return accelerate_group<accelerate_zero>;
         }
     }
 
 
-    static AccelerateFn get_accelerate_y_fn(SpriteName sprite, SpriteMode mode)
+    static AccelerateGroupFn get_accelerate_y_fn(SpriteName sprite, SpriteMode mode)
     {
         using Sprite = SpriteName;
         using Mode = SpriteMode;
@@ -223,7 +244,7 @@ namespace game_punk
         {
         case Sprite::Punk: return get_punk_accelerate_y_fn(mode);
 
-        default: return accelerate_zero;
+        default: return accelerate_group<accelerate_zero>;
         }
     }
 }
@@ -238,6 +259,7 @@ namespace game_punk
     public:
         ContextDims bitmap_dims;
         p32* spritesheet_data = 0;
+        AlphaRuns spritesheet_runs;
 
 
         SpriteView bitmap_at(u32 id) const
@@ -254,6 +276,7 @@ namespace game_punk
             app_assert(data);
         
             view.data = data;
+            view.runs = sub_runs(spritesheet_runs, id * dims.height);
 
             return view;
         }
@@ -370,7 +393,8 @@ namespace game_punk
         app_assert(ok && "*** Invalid spritesheet dimensions ***");
         
         an.base.bitmap_dims = ss.bitmap_dims;
-        an.base.spritesheet_data = ss.data;        
+        an.base.spritesheet_data = ss.data;
+        an.base.spritesheet_runs = ss.runs;
 
         return ok;
     }
@@ -466,10 +490,19 @@ namespace game_punk
     class SpriteTable
     {
     public:
-        struct ID { u32 value_ = 0; };
+        // slot index and the slot generation when spawned
+        struct ID { u32 value_ = 0; u32 generation_ = 0; };
 
         u32 capacity = 0;
-        u32 first_id = 0;
+
+        SlotAllocator slots;
+
+        // one group per (name, mode)
+        static constexpr u32 n_groups = (u32)SpriteName::Count * (u32)SpriteMode::Count;
+
+        // live sprites are [0, slots.size), sorted by group
+        // group g is [group_end[g - 1], group_end[g])
+        u32 group_end[n_groups] = { 0 };
 
         SpriteName* name = 0;
         SpriteMode* mode = 0;
@@ -477,9 +510,6 @@ namespace game_punk
         GameTick64* mode_begin = 0;
         GameTick64* tick_end = 0;
 
-        AccelerateFn* accelerate_x = 0;
-        AccelerateFn* accelerate_y = 0;
-
         TileAcc* acceleration_x = 0;
         TileAcc* acceleration_y = 0;
 
@@ -491,20 +521,27 @@ namespace game_punk
         
         AnimateFn* animate = 0;
         BitmapID* bitmap_id = 0;
+
+        u32 size() const { return slots.size; }
+
+        ID id_at(u32 i) const { auto s = slots.slot[i]; return { s, slots.generation[s] }; }
+
+        // a failed spawn returns an id past the slots
+        u32 at(ID id) const { app_assert(is_allocated(slots, id.value_, id.generation_) && "*** SpriteID not alive ***"); return slots.dense[id.value_]; }
         
-        GameTick64& mode_begin_at(ID id) { return mode_begin[id.value_]; }
+        GameTick64& mode_begin_at(ID id) { return mode_begin[at(id)]; }
+
+        TileSpeed& speed_y_at(ID id) { return speed_y[at(id)]; }
+        TileDim& position_y_at(ID id) { return position_y[at(id)]; }
 
-        TileSpeed& speed_y_at(ID id) { return speed_y[id.value_]; }
-        TileDim& position_y_at(ID id) { return position_y[id.value_]; }
+        AnimateFn& animate_at(ID id) { return animate[at(id)]; }
 
-        AccelerateFn& accelerate_x_at(ID id) { return accelerate_x[id.value_]; }
-        AccelerateFn& accelerate_y_at(ID id) { return accelerate_y[id.value_]; }
-        AnimateFn& animate_at(ID id) { return animate[id.value_]; }
+        u32 group_begin(u32 g) const { return g ? group_end[g - 1] : 0; }
 
-        SpriteName get_name(ID id) const { return name[id.value_]; }
-        TileDim get_tile_x(ID id) const { return position_x[id.value_]; }
-        VecTile get_tile_pos(ID id) const { return { position_x[id.value_], position_y[id.value_] }; }
-        VecSpeed get_tile_velocity(ID id) const { return { speed_x[id.value_], speed_y[id.value_] }; }
+        SpriteName get_name(ID id) const { return name[at(id)]; }
+        TileDim get_tile_x(ID id) const { return position_x[at(id)]; }
+        VecTile get_tile_pos(ID id) const { auto i = at(id); return { position_x[i], position_y[i] }; }
+        VecSpeed get_tile_velocity(ID id) const { auto i = at(id); return { speed_x[i], speed_y[i] }; }
     };
 
 
@@ -512,20 +549,34 @@ namespace game_punk
 
     SpriteID& operator ++ (SpriteID& id) { ++id.value_; return id; }
     bool operator < (SpriteID lhs, SpriteID rhs) { return lhs.value_ < rhs.value_; }
-    bool operator == (SpriteID lhs, SpriteID rhs) { return lhs.value_ == rhs.value_; }    
+    bool operator == (SpriteID lhs, SpriteID rhs) { return lhs.value_ == rhs.value_ && lhs.generation_ == rhs.generation_; }
 
 
-    static void reset_sprite_table(SpriteTable& table)
+    static constexpr u32 sprite_group(SpriteName name, SpriteMode mode)
+    {
+        return (u32)name * (u32)SpriteMode::Count + (u32)mode;
+    }
+
+
+    static constexpr SpriteName group_name(u32 group)
     {
-        table.first_id = 0;
+        return (SpriteName)(group / (u32)SpriteMode::Count);
+    }
+
+
+    static constexpr SpriteMode group_mode(u32 group)
+    {
+        return (SpriteMode)(group % (u32)SpriteMode::Count);
+    }
 
-        auto N = table.capacity;
 
-        for (u32 i = 0; i < N; i++)
+    static void reset_sprite_table(SpriteTable& table)
+    {
+        reset_slots(table.slots);
+
+        for (u32 g = 0; g < table.n_groups; g++)
         {
-            table.mode_begin[i] = GameTick64::none();
-            table.accelerate_x[i] = accelerate_zero;
-            table.accelerate_y[i] = accelerate_zero;
+            table.group_end[g] = 0;
         }
     }
 
@@ -537,16 +588,16 @@ namespace game_punk
         add_count<SpriteName>(counts, capacity);
         add_count<SpriteMode>(counts, capacity);
         
-        add_count<GameTick64>(counts, 2 * capacity);
+        add_count<GameTick64>(counts, capacity, 2);
 
-        add_count<AccelerateFn>(counts, 2 * capacity);
-
-        add_count<TileAcc>(counts, 2 * capacity);
-        add_count<TileSpeed>(counts, 2 * capacity);
-        add_count<TileDim>(counts, 2 * capacity);
+        add_count<TileAcc>(counts, capacity, 2);
+        add_count<TileSpeed>(counts, capacity, 2);
+        add_count<TileDim>(counts, capacity, 2);
 
         add_count<BitmapID>(counts, capacity);
         add_count<AnimateFn>(counts, capacity);
+
+        count_slots(table.slots, counts, capacity);
     }
 
 
@@ -574,12 +625,6 @@ namespace game_punk
         auto tick_end = push_mem<GameTick64>(memory, n);
         ok &= tick_end.ok;
 
-        auto acc_x_fn = push_mem<AccelerateFn>(memory, n);
-        ok &= acc_x_fn.ok;
-
-        auto acc_y_fn = push_mem<AccelerateFn>(memory, n);
-        ok &= acc_y_fn.ok;
-
         auto acc_x = push_mem<TileAcc>(memory, n);
         ok &= acc_x.ok;
 
@@ -604,6 +649,8 @@ namespace game_punk
         auto animate = push_mem<AnimateFn>(memory, n);
         ok &= animate.ok;
 
+        ok &= create_slots(table.slots, memory);
+
         if (ok)
         {
             table.name = name.data;
@@ -612,9 +659,6 @@ namespace game_punk
             table.mode_begin = mode_begin.data;
             table.tick_end = tick_end.data;
 
-            table.accelerate_x = acc_x_fn.data;
-            table.accelerate_y = acc_y_fn.data;
-
             table.acceleration_x = acc_x.data;
             table.acceleration_y = acc_y.data;
 
@@ -637,6 +681,8 @@ namespace game_punk
 
 /* spawn sprite */
 
+#include <utility>
+
 namespace game_punk
 {
     class SpriteDef
@@ -666,46 +712,119 @@ namespace game_punk
     };
 
 
-    static void despawn_sprite(SpriteTable& table, SpriteID id)
+    static bool is_alive(SpriteTable const& table, SpriteID id)
+    {
+        return is_allocated(table.slots, id.value_, id.generation_);
+    }
+
+
+    static void move_sprite(SpriteTable& table, u32 dst, u32 src)
     {
-        auto i = id.value_;
+        table.name[dst] = table.name[src];
+        table.mode[dst] = table.mode[src];
+
+        table.mode_begin[dst] = table.mode_begin[src];
+        table.tick_end[dst] = table.tick_end[src];
 
-        table.mode_begin[i] = GameTick64::none();
-        table.accelerate_x[i] = accelerate_zero;
-        table.accelerate_y[i] = accelerate_zero;
-        table.first_id = math::min(i, table.first_id);
+        table.acceleration_x[dst] = table.acceleration_x[src];
+        table.acceleration_y[dst] = table.acceleration_y[src];
+
+        table.speed_x[dst] = table.speed_x[src];
+        table.speed_y[dst] = table.speed_y[src];
+
+        table.position_x[dst] = table.position_x[src];
+        table.position_y[dst] = table.position_y[src];
+
+        table.animate[dst] = table.animate[src];
+        table.bitmap_id[dst] = table.bitmap_id[src];
     }
 
 
-    static bool is_spawned(SpriteTable const& table, SpriteID id)
+    static void swap_sprites(SpriteTable& table, u32 a, u32 b)
     {
-        return table.mode_begin[id.value_] < table.tick_end[id.value_];
-    }    
-    
-    
-    static SpriteID spawn_sprite(SpriteTable& table, SpriteDef const& def)
+        if (a == b)
+        {
+            return;
+        }
+
+        std::swap(table.name[a], table.name[b]);
+        std::swap(table.mode[a], table.mode[b]);
+
+        std::swap(table.mode_begin[a], table.mode_begin[b]);
+        std::swap(table.tick_end[a], table.tick_end[b]);
+
+        std::swap(table.acceleration_x[a], table.acceleration_x[b]);
+        std::swap(table.acceleration_y[a], table.acceleration_y[b]);
+
+        std::swap(table.speed_x[a], table.speed_x[b]);
+        std::swap(table.speed_y[a], table.speed_y[b]);
+
+        std::swap(table.position_x[a], table.position_x[b]);
+        std::swap(table.position_y[a], table.position_y[b]);
+
+        std::swap(table.animate[a], table.animate[b]);
+        std::swap(table.bitmap_id[a], table.bitmap_id[b]);
+
+        swap_dense(table.slots, a, b);
+    }
+
+
+    // walks the sprite at i across group boundaries, one swap per group, returns its new index
+    static u32 change_group(SpriteTable& table, u32 i, u32 from, u32 to)
     {
-        auto N = table.capacity;
+        auto end = table.group_end;
 
-        SpriteID id;
+        for (u32 g = from; g < to; g++)
+        {
+            auto last = end[g] - 1;
+            swap_sprites(table, i, last);
+            end[g]--;
+            i = last;
+        }
 
-        u32 i = table.first_id;
-        for (; i < N; i++)
-        { 
-            id = { i };
-            if (!is_spawned(table, id))
-            {
-                break;
-            }
+        for (u32 g = from; g > to; g--)
+        {
+            auto first = end[g - 1];
+            swap_sprites(table, i, first);
+            end[g - 1]++;
+            i = first;
         }
 
-        if (i == N)
+        return i;
+    }
+
+
+    static void despawn_sprite(SpriteTable& table, SpriteID id)
+    {
+        if (!is_alive(table, id))
+        {
+            return;
+        }
+
+        constexpr auto last = SpriteTable::n_groups - 1;
+
+        auto i = table.at(id);
+
+        // to the end of the dense range before swap-removing
+        change_group(table, i, sprite_group(table.name[i], table.mode[i]), last);
+        table.group_end[last]--;
+
+        auto d = free_slot(table.slots, id.value_);
+
+        move_sprite(table, d, table.size());
+    }
+    
+    
+    // full table: nothing is spawned and the id is not alive
+    static SpriteID spawn_sprite(SpriteTable& table, SpriteDef const& def)
+    {
+        auto s = alloc_slot(table.slots);
+        if (s == table.capacity)
         {
-            i = 0;
+            return { s, 0 };
         }
 
-        id.value_ = i;
-        table.first_id = i;
+        auto i = table.slots.dense[s];
 
         table.name[i] = def.name;
         table.mode[i] = def.mode;
@@ -713,9 +832,6 @@ namespace game_punk
         table.mode_begin[i] = def.mode_begin;
         table.tick_end[i] = def.tick_end;
 
-        table.accelerate_x[i] = get_accelerate_x_fn(def.name, def.mode);
-        table.accelerate_y[i] = get_accelerate_y_fn(def.name, def.mode);
-
         table.acceleration_x[i] = TileAcc::zero();
         table.acceleration_y[i] = TileAcc::zero();
 
@@ -728,105 +844,201 @@ namespace game_punk
         table.animate[i] = get_animate_fn(def.name, def.mode);
         table.bitmap_id[i] = def.bitmap_id;
 
-        return id;
+        // appended past the last group
+        constexpr auto last = SpriteTable::n_groups - 1;
+        table.group_end[last]++;
+
+        i = change_group(table, i, last, sprite_group(def.name, def.mode));
+
+        return table.id_at(i);
     }
 
 }
 
 
-/* update sprites */
+/* integrate sprites */
 
 namespace game_punk
 {
-    static void set_sprite_mode(SpriteTable& table, SpriteID id, SpriteMode mode, GameTick64 tick)
+    static void integrate_sprites_scalar(TileAcc const* acc, TileSpeed* vel, TileDim* pos, u32 len)
     {
-        if (!is_spawned(table, id))
+        for (u32 i = 0; i < len; i++)
         {
-            return;
+            vel[i] += acc[i];
+            pos[i] += vel[i];
         }
+    }
 
-        auto name = table.get_name(id);
 
-        table.mode_begin_at(id) = tick;
-        table.accelerate_x_at(id) = get_accelerate_x_fn(name, mode);
-        table.accelerate_y_at(id) = get_accelerate_y_fn(name, mode);
-        table.animate_at(id) = get_animate_fn(name, mode);
-    }
-    
-    
-    static void move_sprites_x(SpriteTable const& table, GameTick64 tick)
+    // pos += (i64)vel << POS_SHIFT
+    constexpr u32 POS_SHIFT = units::TILE_DIM_BITS - units::TILE_VALUE_BITS;
+
+    static_assert(sizeof(TileDim) == sizeof(u64));
+    static_assert(sizeof(TileSpeed) == sizeof(i32));
+    static_assert(sizeof(TileAcc) == sizeof(i32));
+
+
+#if defined(MATH_SIMD_256)
+
+    static inline void integrate_sprites(TileAcc const* acc, TileSpeed* vel, TileDim* pos, u32 len)
     {
-        auto N = table.capacity;
+        constexpr u32 N = 8;
 
-        auto beg = table.mode_begin;
+        auto a = (i32 const*)acc;
+        auto v = (i32*)vel;
+        auto p = (u64*)pos;
 
-        auto accfn = table.accelerate_x;
-        auto acc = table.acceleration_x;
-        auto vel = table.speed_x;
-        auto pos = table.position_x;
+        u32 len8 = len / N * N;
+        u32 i = 0;
 
-        for (u32 i = 0; i < N; i++)
+        for (; i < len8; i += N)
         {
-            auto time = tick - beg[i];
+            auto va = _mm256_loadu_si256((__m256i*)(a + i));
+            auto vv = _mm256_add_epi32(_mm256_loadu_si256((__m256i*)(v + i)), va);
 
-            acc[i] = accfn[i](vel[i], time);
-            vel[i] += acc[i];
-            pos[i] += vel[i];
+            _mm256_storeu_si256((__m256i*)(v + i), vv);
+
+            auto lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(vv));
+            auto hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(vv, 1));
+
+            auto p0 = _mm256_loadu_si256((__m256i*)(p + i));
+            auto p1 = _mm256_loadu_si256((__m256i*)(p + i + 4));
+
+            p0 = _mm256_add_epi64(p0, _mm256_slli_epi64(lo, POS_SHIFT));
+            p1 = _mm256_add_epi64(p1, _mm256_slli_epi64(hi, POS_SHIFT));
+
+            _mm256_storeu_si256((__m256i*)(p + i), p0);
+            _mm256_storeu_si256((__m256i*)(p + i + 4), p1);
         }
+
+        integrate_sprites_scalar(acc + i, vel + i, pos + i, len - i);
     }
 
+#elif defined(MATH_SIMD_SSE2)
 
-    static void move_sprites_y(SpriteTable const& table, GameTick64 tick)
+    static inline void integrate_sprites(TileAcc const* acc, TileSpeed* vel, TileDim* pos, u32 len)
     {
-        auto N = table.capacity;
+        constexpr u32 N = 4;
 
-        auto beg = table.mode_begin;
+        auto a = (i32 const*)acc;
+        auto v = (i32*)vel;
+        auto p = (u64*)pos;
 
-        auto accfn = table.accelerate_y;
-        auto acc = table.acceleration_y;
-        auto vel = table.speed_y;
-        auto pos = table.position_y;
+        u32 len4 = len / N * N;
+        u32 i = 0;
 
-        for (u32 i = 0; i < N; i++)
+        for (; i < len4; i += N)
         {
-            auto time = tick - beg[i];
+            auto va = _mm_loadu_si128((__m128i*)(a + i));
+            auto vv = _mm_add_epi32(_mm_loadu_si128((__m128i*)(v + i)), va);
 
-            acc[i] = accfn[i](vel[i], time);
-            vel[i] += acc[i];
-            pos[i] += vel[i];
+            _mm_storeu_si128((__m128i*)(v + i), vv);
+
+            // sign extend without SSE4.1
+            auto sign = _mm_srai_epi32(vv, 31);
+            auto lo = _mm_unpacklo_epi32(vv, sign);
+            auto hi = _mm_unpackhi_epi32(vv, sign);
+
+            auto p0 = _mm_loadu_si128((__m128i*)(p + i));
+            auto p1 = _mm_loadu_si128((__m128i*)(p + i + 2));
+
+            p0 = _mm_add_epi64(p0, _mm_slli_epi64(lo, POS_SHIFT));
+            p1 = _mm_add_epi64(p1, _mm_slli_epi64(hi, POS_SHIFT));
+
+            _mm_storeu_si128((__m128i*)(p + i), p0);
+            _mm_storeu_si128((__m128i*)(p + i + 2), p1);
         }
+
+        integrate_sprites_scalar(acc + i, vel + i, pos + i, len - i);
     }
 
+#else
 
-    static void move_sprites_xy(SpriteTable const& table, GameTick64 tick)
+    static inline void integrate_sprites(TileAcc const* acc, TileSpeed* vel, TileDim* pos, u32 len)
     {
-        auto N = table.capacity;
+        integrate_sprites_scalar(acc, vel, pos, len);
+    }
+
+#endif
+}
 
-        auto beg = table.mode_begin;
 
-        auto accfn_x = table.accelerate_x;
-        auto accfn_y = table.accelerate_y;
+/* update sprites */
 
-        auto acc_x = table.acceleration_x;
-        auto vel_x = table.speed_x;
-        auto pos_x = table.position_x;
+namespace game_punk
+{
+    static void set_sprite_mode(SpriteTable& table, SpriteID id, SpriteMode mode, GameTick64 tick)
+    {
+        if (!is_alive(table, id))
+        {
+            return;
+        }
 
-        auto acc_y = table.acceleration_y;
-        auto vel_y = table.speed_y;
-        auto pos_y = table.position_y;
+        auto i = table.at(id);
+        auto name = table.name[i];
+        auto from = sprite_group(name, table.mode[i]);
 
-        for (u32 i = 0; i < N; i++)
+        table.mode[i] = mode;
+        table.mode_begin[i] = tick;
+        table.animate[i] = get_animate_fn(name, mode);
+
+        change_group(table, i, from, sprite_group(name, mode));
+    }
+
+
+    static void accelerate_sprites_x(SpriteTable const& table, GameTick64 tick)
+    {
+        for (u32 g = 0; g < table.n_groups; g++)
         {
-            auto time = tick - beg[i];
+            auto begin = table.group_begin(g);
+            auto count = table.group_end[g] - begin;
+            if (!count)
+            {
+                continue;
+            }
 
-            acc_x[i] = accfn_x[i](vel_x[i], time);
-            acc_y[i] = accfn_y[i](vel_y[i], time);
+            auto accfn = get_accelerate_x_fn(group_name(g), group_mode(g));
+            accfn(table.acceleration_x + begin, table.speed_x + begin, table.mode_begin + begin, count, tick);
+        }
+    }
 
-            vel_x[i] += acc_x[i];
-            vel_y[i] += acc_y[i];
 
-            pos_x[i] += vel_x[i];
-            pos_y[i] += vel_y[i];
+    static void accelerate_sprites_y(SpriteTable const& table, GameTick64 tick)
+    {
+        for (u32 g = 0; g < table.n_groups; g++)
+        {
+            auto begin = table.group_begin(g);
+            auto count = table.group_end[g] - begin;
+            if (!count)
+            {
+                continue;
+            }
+
+            auto accfn = get_accelerate_y_fn(group_name(g), group_mode(g));
+            accfn(table.acceleration_y + begin, table.speed_y + begin, table.mode_begin + begin, count, tick);
         }
     }
+    
+    
+    static void move_sprites_x(SpriteTable const& table, GameTick64 tick)
+    {
+        accelerate_sprites_x(table, tick);
+        integrate_sprites(table.acceleration_x, table.speed_x, table.position_x, table.size());
+    }
+
+
+    static void move_sprites_y(SpriteTable const& table, GameTick64 tick)
+    {
+        accelerate_sprites_y(table, tick);
+        integrate_sprites(table.acceleration_y, table.speed_y, table.position_y, table.size());
+    }
+
+
+    static void move_sprites_xy(SpriteTable const& table, GameTick64 tick)
+    {
+        PROFILE_ZONE(MoveSprites);
+
+        move_sprites_x(table, tick);
+        move_sprites_y(table, tick);
+    }
 }
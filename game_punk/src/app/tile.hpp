@@ -10,6 +10,9 @@ namespace game_punk
     public:
         TileView floor_a;
         TileView floor_b;
+
+        Opacity opacity_a = Opacity::Mixed;
+        Opacity opacity_b = Opacity::Mixed;
     };
 
 
@@ -45,14 +48,24 @@ namespace game_punk
     class TileTable
     {
     public:
-        struct ID { u32 value_ = 0; };
+        // slot index and the slot generation when spawned
+        struct ID { u32 value_ = 0; u32 generation_ = 0; };
 
         u32 capacity = 0;
-        u32 first_id = {0};
 
+        SlotAllocator slots;
+
+        // live tiles are [0, slots.size)
         GameTick64* tick_begin = 0;
         VecTile* position = 0;
         BitmapID* bitmap_id = 0;
+
+        u32 size() const { return slots.size; }
+
+        ID id_at(u32 i) const { auto s = slots.slot[i]; return { s, slots.generation[s] }; }
+
+        // a failed spawn returns an id past the slots
+        u32 at(ID id) const { app_assert(is_allocated(slots, id.value_, id.generation_) && "*** TileID not alive ***"); return slots.dense[id.value_]; }
     };
 
 
@@ -60,6 +73,7 @@ namespace game_punk
 
     TileID& operator ++ (TileID& id) { ++id.value_; return id; }
     bool operator < (TileID lhs, TileID rhs) { return lhs.value_ < rhs.value_; }
+    bool operator == (TileID lhs, TileID rhs) { return lhs.value_ == rhs.value_ && lhs.generation_ == rhs.generation_; }
 
 
     class TileDef
@@ -82,9 +96,7 @@ namespace game_punk
 
     static void reset_tile_table(TileTable& table)
     {
-        table.first_id = 0;
-
-        span::fill(span::make_view(table.tick_begin, table.capacity), GameTick64::none());
+        reset_slots(table.slots);
     }
 
 
@@ -95,6 +107,8 @@ namespace game_punk
         add_count<GameTick64>(counts, capacity);
         add_count<VecTile>(counts, capacity);
         add_count<BitmapID>(counts, capacity);
+
+        count_slots(table.slots, counts, capacity);
     }
 
 
@@ -119,6 +133,8 @@ namespace game_punk
         auto bmp = push_mem<BitmapID>(memory, n);
         ok &= bmp.ok;
 
+        ok &= create_slots(table.slots, memory);
+
         if (ok)
         {
             table.tick_begin = tick_begin.data;
@@ -130,47 +146,176 @@ namespace game_punk
     }
     
     
-    static void despawn_tile(TileTable& table, TileID id)
+    static bool is_alive(TileTable const& table, TileID id)
     {
-        auto i = id.value_;
-
-        table.tick_begin[i] = GameTick64::none();
-        table.first_id = math::min(i, table.first_id);
+        return is_allocated(table.slots, id.value_, id.generation_);
     }
+    
+    
+    static void despawn_tile(TileTable& table, TileID id)
+    {
+        if (!is_alive(table, id))
+        {
+            return;
+        }
 
+        auto d = free_slot(table.slots, id.value_);
+        auto last = table.size();
 
-    static bool is_spawned(TileTable const& table,TileID id)
-    {
-        return table.tick_begin[id.value_] != GameTick64::none();
+        table.tick_begin[d] = table.tick_begin[last];
+        table.position[d] = table.position[last];
+        table.bitmap_id[d] = table.bitmap_id[last];
     }
     
     
+    // full table: nothing is spawned and the id is not alive
     static TileID spawn_tile(TileTable& table, TileDef const& tile)
     {
-        auto N = table.capacity;
-
-        TileID id;
-        u32 i = table.first_id;
-        for (; i < N; i++)
+        auto s = alloc_slot(table.slots);
+        if (s == table.capacity)
         {
-            id = { i };
-            if (!is_spawned(table, id))
-            {
-                break;
-            }
+            return { s, 0 };
         }
 
-        if (i == N)
-        {
-            i = 0;
-        }
-        
-        table.first_id = i;
+        auto i = table.slots.dense[s];
+
         table.tick_begin[i] = tile.tick_begin;
         table.position[i] = tile.position;
         table.bitmap_id[i] = tile.bitmap_id;
 
-        return id;
+        return table.id_at(i);
     }
-    
-}
\ No newline at end of file
+}
+
+
+/* tile strip */
+
+namespace game_punk
+{
+    // floor tiles pre-rendered in spawn order, tile i is in slot i % capacity
+    class TileStrip
+    {
+    public:
+        // live tiles span the scene plus the despawn margin
+        static constexpr u32 capacity = (cxpr::GAME_BACKGROUND_WIDTH_PX * 5 / 4) / cxpr::TILE_WIDTH_PX + 4;
+
+        // rotated, one slot is one tile
+        static constexpr u32 slot_width = cxpr::TILE_HEIGHT_PX;
+        static constexpr u32 slot_height = cxpr::TILE_WIDTH_PX;
+
+        p32* data = 0;
+
+        // source of each slot, the pixels are redrawn from it on restore
+        BitmapID bitmap_id[capacity];
+
+        u32 begin = 0;
+        u32 end = 0;
+
+        // most recent tile
+        VecTile last_pos;
+
+        Opacity opacity = Opacity::Opaque;
+        u32 version = 0;
+    };
+
+
+    static void reset_tile_strip(TileStrip& strip)
+    {
+        strip.begin = 0;
+        strip.end = 0;
+        strip.last_pos = vec_zero<TileDim>();
+        strip.opacity = Opacity::Opaque;
+        strip.version++;
+    }
+
+
+    static void count_tile_strip(TileStrip& strip, MemoryCounts& counts)
+    {
+        add_count<p32>(counts, strip.capacity * strip.slot_width * strip.slot_height);
+    }
+
+
+    static bool create_tile_strip(TileStrip& strip, Memory& memory)
+    {
+        auto res = push_mem<p32>(memory, strip.capacity * strip.slot_width * strip.slot_height);
+        if (res.ok)
+        {
+            strip.data = res.data;
+        }
+
+        return res.ok;
+    }
+
+
+    static ImageView slot_view(TileStrip const& strip, u32 slot, u32 n_slots)
+    {
+        auto W = strip.slot_width;
+        auto H = strip.slot_height;
+
+        return img::make_view(W, n_slots * H, strip.data + slot * W * H);
+    }
+
+
+    static void drop_tile(TileStrip& strip)
+    {
+        strip.begin++;
+    }
+
+
+    static void draw_slot(TileStrip& strip, u32 slot, DrawBitmap const& bitmap)
+    {
+        auto& view = bitmap.view;
+
+        [[maybe_unused]] bool ok = view.width == strip.slot_width && view.height == strip.slot_height;
+        app_assert(ok && "*** Unexpected floor tile ***");
+
+        span::copy(img::to_span(view), img::to_span(slot_view(strip, slot, 1)));
+    }
+
+
+    static void append_tile(TileStrip& strip, BitmapTable& bitmaps, BitmapID bmp, VecTile pos)
+    {
+        auto& bitmap = bitmaps.item_at(bmp);
+
+        if (strip.end - strip.begin == strip.capacity)
+        {
+            drop_tile(strip);
+        }
+
+        auto slot = strip.end % strip.capacity;
+        draw_slot(strip, slot, bitmap);
+        strip.bitmap_id[slot] = bmp;
+
+        if (bitmap.opacity != Opacity::Opaque)
+        {
+            strip.opacity = Opacity::Mixed;
+        }
+
+        strip.last_pos = pos;
+        strip.end++;
+        strip.version++;
+    }
+
+
+    // live slots from their bitmaps
+    static void redraw_tile_strip(TileStrip& strip, BitmapTable& bitmaps)
+    {
+        for (u32 i = strip.begin; i < strip.end; i++)
+        {
+            auto slot = i % strip.capacity;
+            draw_slot(strip, slot, bitmaps.item_at(strip.bitmap_id[slot]));
+        }
+    }
+
+
+    static ScenePosition tile_scene_pos(TileStrip const& strip, u32 tile, GameScene const& scene)
+    {
+        constexpr auto tile_w = (i32)cxpr::TILE_WIDTH_PX;
+
+        // from the most recent tile, always right of the scene origin
+        auto last = to_scene_pos(strip.last_pos, scene).pos_game();
+        auto back = SceneDim::make((i32)(strip.end - 1 - tile) * tile_w);
+
+        return ScenePosition(last.x - back, last.y, DimCtx::Game);
+    }
+}
@@ -7,7 +7,11 @@ namespace game_punk
 {
 namespace units
 {
-    constexpr i32 BASE_TILE_VALUE = 100000;
+    // TileValue is 16.16 fixed point, TileDimension is 32.32
+    constexpr u32 TILE_VALUE_BITS = 16;
+    constexpr u32 TILE_DIM_BITS = 32;
+
+    constexpr i32 BASE_TILE_VALUE = 1 << TILE_VALUE_BITS;
 
 
     class TileValue
@@ -92,67 +96,41 @@ namespace units
     class TileDimension
     {
     private:
-        
-        class ValueT
-        {
-        public:
-            u32 i_part;
-            i32 f_part;
-
-            constexpr ValueT(){}
-        };
+        static constexpr u32 SHIFT = TILE_DIM_BITS - TILE_VALUE_BITS;
+        static constexpr u64 F_MASK = ((u64)1 << TILE_DIM_BITS) - 1;
 
-        ValueT value_;
-
-        constexpr TileDimension(u32 i, i32 f) 
-        { 
-            i += (f / BASE_TILE_VALUE);
-            f %= BASE_TILE_VALUE;
-
-            i32 adj = (f < 0);
-            value_.i_part = i - adj;
-            value_.f_part = f + adj * BASE_TILE_VALUE;
-        }
+        constexpr TileDimension(u64 v) { value_ = v; }
 
-
-        void add(i32 f_delta)
-        {
-            u32 i = value_.i_part;
-            i32 f = value_.f_part + f_delta;
-
-            i += (f / BASE_TILE_VALUE);
-            f %= BASE_TILE_VALUE;
-            
-            i32 adj = (f < 0);
-            value_.i_part = i - adj;
-            value_.f_part = f + adj * BASE_TILE_VALUE;
-        }
+        static constexpr u64 to_dim(i32 v) { return (u64)((i64)v << SHIFT); }
 
     public:
 
+        // integer part wraps as u32
+        u64 value_;
+
         TileDimension() = delete;
 
-        static constexpr TileDimension make(TileValue v) { return TileDimension(v.value_, 0); }
-        static constexpr TileDimension zero() { return TileDimension(0u, 0); }
+        static constexpr TileDimension make(TileValue v) { return TileDimension((u64)v.value_ << TILE_DIM_BITS); }
+        static constexpr TileDimension zero() { return TileDimension((u64)0); }
 
         static TileDimension make(f32 v) = delete;
 
-        TileDimension& operator += (TileSpeed other) { add(other.value_.value_); return *this; }
-        TileDimension& operator -= (TileSpeed other) { add(-other.value_.value_); return *this; }
+        TileDimension& operator += (TileSpeed other) { value_ += to_dim(other.value_.value_); return *this; }
+        TileDimension& operator -= (TileSpeed other) { value_ -= to_dim(other.value_.value_); return *this; }
 
         TileDelta operator - (TileDimension other) 
         {
-            u32 i = value_.i_part - other.value_.i_part;
-            i32 f = value_.f_part - other.value_.f_part;
-
-            i32 n = i * BASE_TILE_VALUE + f;
+            auto d = (i64)(value_ - other.value_);
 
-            return TileDelta::make(TileValue::make(n));
+            return TileDelta::make(TileValue::make((i32)(d >> SHIFT)));
         }
 
-        bool operator <= (TileDimension other) { return get() <= other.get(); }
+        bool operator <= (TileDimension other) { return value_ <= other.value_; }
+
+        // floor(n * value) without overflowing the fraction
+        u64 scale(u32 n) const { return (value_ >> TILE_DIM_BITS) * n + (((value_ & F_MASK) * n) >> TILE_DIM_BITS); }
 
-        f32 get() { return (f32)value_.i_part + (f32)value_.f_part / BASE_TILE_VALUE; }
+        f32 get() { return (f32)(u32)(value_ >> TILE_DIM_BITS) + (f32)(value_ & F_MASK) / (f32)(F_MASK + 1); }
     };
 
 
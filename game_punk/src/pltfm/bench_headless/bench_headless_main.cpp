@@ -0,0 +1,604 @@
+#include <cstdio>
+#include <cstdlib>
+
+#define app_assert(...)
+#define app_log(...)
+#define app_crash(...)
+
+#include "../../../../libs/io/input/input_state.hpp"
+#include "../../../../libs/io/input/input_record.hpp"
+#include "../../../../libs/io/filesystem.hpp"
+#include "../../../../libs/datetime/datetime.hpp"
+
+#include "../../app/app.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace mb = memory_buffer;
+namespace img = image;
+namespace game = game_punk;
+namespace dt = datetime;
+
+
+constexpr u32 DEFAULT_FRAMES = 10'000;
+
+
+using Stopwatch = dt::Stopwatch;
+
+
+/* main variables */
+
+namespace mv
+{
+    input::InputArray input;
+    input::InputReplay replay;
+
+    game::AppState app_state;
+
+    u64 seed = game::DEFAULT_SEED;
+
+    img::Buffer32 screen_buffer;
+
+    f64* frame_ms = 0;
+
+    constexpr int MAIN_ERROR = 1;
+    constexpr int MAIN_OK = 0;
+}
+
+
+/* memory */
+
+// no allocation tracking, libs/alloc_type counts are SDL only
+namespace mem
+{
+    void* alloc_any(u32 n_elements, u32 element_size) { return std::malloc(n_elements * element_size); }
+
+    void free_any(void* ptr) { std::free(ptr); }
+
+    void* alloc_memory(u32 n_elements, u32 element_size) { return std::calloc(n_elements, element_size); }
+
+    void* alloc_memory(u32 n_elements, u32 element_size, cstr tag) { return std::calloc(n_elements, element_size); }
+
+    void free_memory(void* ptr, u32 element_size) { std::free(ptr); }
+
+    void add_memory(void* ptr, u32 n_elements, u32 element_size, cstr tag) {}
+
+    void tag_memory(void* ptr, u32 n_elements, u32 element_size, cstr tag) {}
+
+    void tag_file_memory(void* ptr, u32 element_size, cstr file_path) {}
+
+    void untag_memory(void* ptr, u32 element_size) {}
+
+    void* alloc_memory(u32 n_bytes, Alloc type) { return std::malloc(n_bytes); }
+
+    void* realloc_memory(void* ptr, u32 n_bytes, Alloc type) { return std::realloc(ptr, n_bytes); }
+
+    void free_memory(void* ptr, Alloc type) { std::free(ptr); }
+}
+
+
+/* filesystem */
+
+namespace fs
+{
+    u32 file_size(cstr file_path)
+    {
+        auto file = std::fopen(file_path, "rb");
+        if (!file)
+        {
+            return 0;
+        }
+
+        std::fseek(file, 0, SEEK_END);
+        auto size = std::ftell(file);
+        std::fclose(file);
+
+        return size > 0 ? (u32)size : 0;
+    }
+
+
+    MemoryBuffer<u8> read_bytes(cstr file_path)
+    {
+        MemoryBuffer<u8> buffer;
+        buffer.ok = 0;
+
+        auto size = file_size(file_path);
+        if (!size)
+        {
+            return buffer;
+        }
+
+        auto file = std::fopen(file_path, "rb");
+        if (!file)
+        {
+            return buffer;
+        }
+
+        if (!mb::create_buffer(buffer, size, get_file_name(file_path)))
+        {
+            std::fclose(file);
+            return buffer;
+        }
+
+        buffer.size_ = (u32)std::fread(buffer.data_, 1, size, file);
+        buffer.ok = buffer.size_ == size;
+
+        std::fclose(file);
+
+        return buffer;
+    }
+
+
+    void select_image_file(SingleFileResult* result) {}
+
+
+    // load time is not measured, assets use the heap fallback
+    MemoryBuffer<u8> map_bytes(cstr file_path) { MemoryBuffer<u8> b; b.ok = 0; return b; }
+
+    void unmap_bytes(MemoryBuffer<u8>& buffer) {}
+}
+
+
+/* scripted input */
+
+namespace script
+{
+    enum class Key : u8
+    {
+        Return,
+        Space,
+        Right
+    };
+
+
+    class Step
+    {
+    public:
+        u32 frame_begin;
+        u32 frame_end;
+        Key key;
+    };
+
+
+    // start game, run, jump
+    constexpr Step STEPS[] = {
+        { 30,  32,  Key::Return },
+        { 60,  62,  Key::Return },
+        { 120, 360, Key::Right },
+        { 200, 202, Key::Space },
+        { 400, 402, Key::Space },
+        { 420, 640, Key::Right },
+        { 600, 602, Key::Space },
+    };
+
+    constexpr u32 SCRIPT_FRAMES = 720;
+
+
+    static bool is_down(Key key, u32 frame)
+    {
+        auto f = frame % SCRIPT_FRAMES;
+
+        for (auto const& step : STEPS)
+        {
+            if (step.key == key && f >= step.frame_begin && f < step.frame_end)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    static void record_input(input::InputArray& inputs, u32 frame)
+    {
+        auto& prev = inputs.prev();
+        auto& curr = inputs.curr();
+
+        input::copy_input_state(prev, curr);
+        curr.frame = prev.frame + 1;
+        curr.dt_frame = 1.0f / 60.0f;
+        curr.flags = 0;
+
+        auto& pk = prev.keyboard;
+        auto& ck = curr.keyboard;
+
+        input::record_button_input(pk.kbd_return, ck.kbd_return, is_down(Key::Return, frame));
+        input::record_button_input(pk.kbd_space, ck.kbd_space, is_down(Key::Space, frame));
+        input::record_button_input(pk.kbd_right, ck.kbd_right, is_down(Key::Right, frame));
+    }
+}
+
+
+/* rollback */
+
+// every frame is saved, every INTERVAL frames the last FRAMES are restored and resimulated
+namespace rollback
+{
+    constexpr u32 INTERVAL = 60;
+    constexpr u32 FRAMES = 8;
+
+    // frame f is in f % FRAMES
+    input::Input inputs[FRAMES];
+
+    f64* save_us = 0;
+    f64* restore_us = 0;
+    u32 n_saves = 0;
+    u32 n_restores = 0;
+
+    // screen before the rollback
+    u32* screen = 0;
+    u32 n_diff = 0;
+
+
+    static bool init(u32 n_frames, u32 screen_length)
+    {
+        auto n_restores = n_frames / INTERVAL + 1;
+
+        save_us = (f64*)std::malloc((n_frames + n_restores * FRAMES) * sizeof(f64));
+        restore_us = (f64*)std::malloc(n_restores * sizeof(f64));
+        screen = (u32*)std::malloc(screen_length * sizeof(u32));
+
+        return save_us && restore_us && screen;
+    }
+
+
+    static void close()
+    {
+        std::free(save_us);
+        std::free(restore_us);
+        std::free(screen);
+    }
+
+
+    static void save(game::AppState& state)
+    {
+        Stopwatch sw;
+
+        sw.start();
+        game::save_snapshot(state);
+        save_us[n_saves++] = sw.get_time_nano_f64() / 1000.0;
+    }
+
+
+    static void run(game::AppState& state, img::Buffer32 const& screen_buffer, u32 frame)
+    {
+        if (frame < FRAMES || frame % INTERVAL != INTERVAL - 1)
+        {
+            return;
+        }
+
+        auto n_bytes = screen_buffer.capacity_ * sizeof(u32);
+        std::memcpy(screen, screen_buffer.data_, n_bytes);
+
+        auto state_hash = game::hash_state(state);
+
+        Stopwatch sw;
+
+        sw.start();
+        auto ok = game::restore_snapshot(state, FRAMES);
+        restore_us[n_restores++] = sw.get_time_nano_f64() / 1000.0;
+
+        if (!ok)
+        {
+            n_diff++;
+            return;
+        }
+
+        for (u32 f = frame - FRAMES + 1; f <= frame; f++)
+        {
+            game::update(state, inputs[f % FRAMES]);
+            save(state);
+        }
+
+        n_diff += std::memcmp(screen, screen_buffer.data_, n_bytes) != 0 || game::hash_state(state) != state_hash;
+    }
+}
+
+
+/* hash */
+
+// chained over all frames, optionally one line per frame for diffing runs
+namespace hash
+{
+    u64 state = 0;
+    u64 screen = 0;
+
+    FILE* file = 0;
+
+
+    static void update(game::AppState& app_state, u32 frame)
+    {
+        auto hs = game::hash_state(app_state);
+        auto hp = game::hash_screen(app_state);
+
+        state = hs ^ (state * 0x100000001B3ull);
+        screen = hp ^ (screen * 0x100000001B3ull);
+
+        if (file)
+        {
+            std::fprintf(file, "%u %016llx %016llx\n", frame, (unsigned long long)hs, (unsigned long long)hp);
+        }
+    }
+}
+
+
+/* replay */
+
+// inputs and hashes of the run, replayed after game::reset must match frame for frame
+namespace rerun
+{
+    input::Input* inputs = 0;
+    u64* states = 0;
+    u64* screens = 0;
+
+    u32 n_diff = 0;
+
+
+    static bool init(u32 n_frames)
+    {
+        inputs = (input::Input*)std::malloc(n_frames * sizeof(input::Input));
+        states = (u64*)std::malloc(n_frames * sizeof(u64));
+        screens = (u64*)std::malloc(n_frames * sizeof(u64));
+
+        return inputs && states && screens;
+    }
+
+
+    static void close()
+    {
+        std::free(inputs);
+        std::free(states);
+        std::free(screens);
+    }
+
+
+    static void record(game::AppState& state, input::Input const& input, u32 frame)
+    {
+        inputs[frame] = input;
+        states[frame] = game::hash_state(state);
+        screens[frame] = game::hash_screen(state);
+    }
+
+
+    static void run(game::AppState& state, u64 seed, u32 n_frames)
+    {
+        game::reset(state, seed);
+
+        for (u32 f = 0; f < n_frames; f++)
+        {
+            game::update(state, inputs[f]);
+
+            n_diff += game::hash_state(state) != states[f] || game::hash_screen(state) != screens[f];
+        }
+    }
+}
+
+
+/* report */
+
+namespace report
+{
+    static f64 percentile(f64* sorted, u32 count, f64 p)
+    {
+        auto i = (u32)(p * (count - 1) + 0.5);
+        return sorted[i];
+    }
+
+
+    static void print_stats(f64* times, u32 count, f64 total_ms)
+    {
+        std::sort(times, times + count);
+
+        auto mean = total_ms / count;
+        auto p50 = percentile(times, count, 0.50);
+        auto p99 = percentile(times, count, 0.99);
+        auto max = times[count - 1];
+        auto fps = 1000.0 / mean;
+
+        std::printf("%s %s headless\n", game::APP_TITLE, game::VERSION);
+        std::printf("frames: %u\n", count);
+        std::printf("mean:   %9.4f ms\n", mean);
+        std::printf("p50:    %9.4f ms\n", p50);
+        std::printf("p99:    %9.4f ms\n", p99);
+        std::printf("max:    %9.4f ms\n", max);
+        std::printf("fps:    %9.1f\n", fps);
+    }
+
+
+    static void print_us(cstr label, f64* times, u32 count)
+    {
+        if (!count)
+        {
+            return;
+        }
+
+        f64 total = 0.0;
+        for (u32 i = 0; i < count; i++)
+        {
+            total += times[i];
+        }
+
+        std::sort(times, times + count);
+
+        auto mean = total / count;
+        auto p99 = percentile(times, count, 0.99);
+        auto max = times[count - 1];
+
+        std::printf("%-8s %6u x  mean %8.3f us  p99 %8.3f us  max %8.3f us\n", label, count, mean, p99, max);
+    }
+}
+
+
+static bool main_init(u32 n_frames)
+{
+    input::reset_input_state(mv::input.prev());
+    input::reset_input_state(mv::input.curr());
+
+    auto result = game::init(mv::app_state);
+    if (!result.success)
+    {
+        std::printf("%s\n", game::decode_error(result.error));
+        return false;
+    }
+
+    auto w = result.app_dimensions.x;
+    auto h = result.app_dimensions.y;
+
+    mv::screen_buffer = img::create_buffer32(w * h, "screen");
+    if (!mv::screen_buffer.ok)
+    {
+        return false;
+    }
+
+    auto screen = img::make_view(w, h, mv::screen_buffer);
+
+    if (!game::set_screen_memory(mv::app_state, screen))
+    {
+        return false;
+    }
+
+    mv::frame_ms = (f64*)std::malloc(n_frames * sizeof(f64));
+
+    return mv::frame_ms && rollback::init(n_frames, w * h) && rerun::init(n_frames);
+}
+
+
+static void main_close()
+{
+    input::end_replay(mv::replay);
+
+    if (hash::file)
+    {
+        std::fclose(hash::file);
+    }
+    std::free(mv::frame_ms);
+    rollback::close();
+    rerun::close();
+
+    game::close(mv::app_state);
+    mb::destroy_buffer(mv::screen_buffer);
+}
+
+
+static u32 main_loop(u32 n_frames, f64& total)
+{
+    Stopwatch sw;
+    total = 0.0;
+
+    auto replay = input::is_replaying(mv::replay);
+
+    for (u32 f = 0; f < n_frames; f++)
+    {
+        script::record_input(mv::input, f);
+        auto input = &mv::input.curr();
+
+        if (replay)
+        {
+            if (!input::replay_input(mv::replay))
+            {
+                return f;
+            }
+
+            input = &mv::replay.input;
+        }
+
+        sw.start();
+
+        game::update(mv::app_state, *input);
+
+        auto ms = sw.get_time_milli_f64();
+        mv::frame_ms[f] = ms;
+        total += ms;
+
+        rollback::inputs[f % rollback::FRAMES] = *input;
+        rollback::save(mv::app_state);
+        rollback::run(mv::app_state, mv::screen_buffer, f);
+
+        hash::update(mv::app_state, f);
+        rerun::record(mv::app_state, *input, f);
+
+        mv::input.swap();
+    }
+
+    return n_frames;
+}
+
+
+int main(int argc, char** argv)
+{
+    u32 n_frames = DEFAULT_FRAMES;
+    if (argc > 1)
+    {
+        auto n = std::atoi(argv[1]);
+        n_frames = n > 0 ? (u32)n : DEFAULT_FRAMES;
+    }
+
+    if (!main_init(n_frames))
+    {
+        main_close();
+        return mv::MAIN_ERROR;
+    }
+
+    // "-" runs the script without a replay
+    auto replay = argc > 2 && std::strcmp(argv[2], "-") != 0;
+
+    if (replay && !input::begin_replay(mv::replay, argv[2]))
+    {
+        std::printf("bad replay file: %s\n", argv[2]);
+        main_close();
+        return mv::MAIN_ERROR;
+    }
+
+    // per frame hashes, diff two files for the first divergent frame
+    if (argc > 3 && !(hash::file = std::fopen(argv[3], "w")))
+    {
+        std::printf("bad hash file: %s\n", argv[3]);
+        main_close();
+        return mv::MAIN_ERROR;
+    }
+
+    // same seed and inputs give the same hashes
+    if (argc > 4)
+    {
+        mv::seed = std::strtoull(argv[4], 0, 0);
+        game::reset(mv::app_state, mv::seed);
+    }
+
+    f64 total = 0.0;
+    n_frames = main_loop(n_frames, total);
+    if (!n_frames)
+    {
+        main_close();
+        return mv::MAIN_ERROR;
+    }
+
+    report::print_stats(mv::frame_ms, n_frames, total);
+
+    std::printf("\nsnapshots, rollback %u frames every %u\n", rollback::FRAMES, rollback::INTERVAL);
+    report::print_us("save", rollback::save_us, rollback::n_saves);
+    report::print_us("restore", rollback::restore_us, rollback::n_restores);
+    std::printf("rollback frames differ: %u\n", rollback::n_diff);
+
+    std::printf("\nseed:        %llu\n", (unsigned long long)mv::seed);
+    std::printf("state hash:  %016llx\n", (unsigned long long)hash::state);
+    std::printf("screen hash: %016llx\n", (unsigned long long)hash::screen);
+
+    rerun::run(mv::app_state, mv::seed, n_frames);
+    std::printf("\nreplay after reset, frames differ: %u\n", rerun::n_diff);
+
+    main_close();
+
+    return mv::MAIN_OK;
+}
+
+
+#include "../../../../libs/span/span.cpp"
+#include "../../../../libs/image/image.cpp"
+#include "../../../../libs/stb_libs/stb_libs.cpp"
+#include "../../../../libs/math/math.cpp"
+#include "../../../../libs/datetime/datetime.cpp"
+
+#include "../../app/app.cpp"
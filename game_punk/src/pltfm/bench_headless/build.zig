@@ -0,0 +1,79 @@
+const std = @import("std");
+
+const main_cpp = "./bench_headless_main.cpp";
+
+const app_name = "punk_bench";
+
+
+const root_dir = "../../..";
+const res_dir = root_dir ++ "/res";
+const bin_data = res_dir ++ "/xbin/punk_run.bin";
+
+
+const cpp_flags = &[_][]const u8{
+    "-std=c++20",
+    "-mavx",
+    "-mavx2",
+    "-mfma",
+    "-DNDEBUG",
+    "-O3",
+    "-DGAME_PUNK_RELEASE",
+    "-DIMAGE_READ",
+    "-DGAME_PUNK_DRAW_MT",
+};
+
+
+const cpp_libs = &[_][]const u8{
+    "pthread",
+};
+
+
+pub fn build(b: *std.Build) void 
+{
+    const optimize = b.option(std.builtin.OptimizeMode, "optimize", "Optimization mode") orelse .ReleaseFast;
+
+
+    const exe = b.addExecutable(.{
+        .name = app_name,
+        .root_module = b.createModule(.{
+            .root_source_file = null,
+            .target = b.graph.host,
+            .optimize = optimize,
+        }),
+    });
+
+    exe.addCSourceFiles(.{
+        .files = &.{
+            main_cpp,
+        },
+        .flags = cpp_flags,
+    });
+
+    for (cpp_libs) |lib|
+    {
+        exe.linkSystemLibrary(lib);
+    }
+    
+    exe.linkLibC();
+    exe.linkLibCpp();
+
+    b.installArtifact(exe);
+
+
+    // Copy punk_run.bin next to the exe in zig-out/bin
+    const copy_data = b.addInstallBinFile(
+        b.path(bin_data),
+        "punk_run.bin",
+    );
+    b.getInstallStep().dependOn(&copy_data.step);
+
+    // zig build run -- <frames>
+    const run_step = b.step("run", "Run");
+    const run_cmd = b.addRunArtifact(exe);
+    if (b.args) |args| run_cmd.addArgs(args);
+    run_step.dependOn(&run_cmd.step);
+}
+
+// zig build -Doptimize=Debug          # full debug symbols, no -O3, assertions on
+// zig build -Doptimize=ReleaseSafe    # safe release (keeps bounds checks)
+// zig build -Doptimize=ReleaseFast    # your current -O3 mode (default above)
\ No newline at end of file
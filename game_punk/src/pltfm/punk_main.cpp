@@ -1,5 +1,6 @@
 #include "../../../libs/io/window.hpp"
 #include "../../../libs/io/input/input.hpp"
+#include "../../../libs/io/input/input_record.hpp"
 #include "../../../libs/io/message.hpp"
 #include "../../../libs/datetime/datetime.hpp"
 
@@ -47,6 +48,9 @@ namespace mv
     game::AppState app_state;
     Stopwatch frame_sw;
 
+    input::InputRecorder recorder;
+    input::InputReplay replay;
+
     constexpr int MAIN_ERROR = 1;
     constexpr int MAIN_OK = 0;
 
@@ -132,6 +136,8 @@ static bool window_create_fullscreen(Vec2Du32 game_dims)
 
 static void window_render(b8 window_size_changed)
 {
+    PROFILE_ZONE(WindowRender);
+
 #ifdef APP_ROTATE_90
     window::render(mv::window, mv::GAME_ROTATE, window_size_changed);
 #else
@@ -220,10 +226,41 @@ static bool main_init()
 }
 
 
+static bool parse_args(int argc, char* argv[])
+{
+    // --record <file> | --replay <file>
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        auto arg = argv[i];
+        auto path = argv[i + 1];
+
+        if (!std::strcmp(arg, "--record"))
+        {
+            if (!input::begin_record(mv::recorder, path))
+            {
+                return false;
+            }
+        }
+        else if (!std::strcmp(arg, "--replay"))
+        {
+            if (!input::begin_replay(mv::replay, path))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
 void main_close()
 {
     mv::run_state = RunState::End;
 
+    input::end_record(mv::recorder);
+    input::end_replay(mv::replay);
+
     game::close(mv::app_state);
     input::close();
     window::close();
@@ -242,7 +279,29 @@ static void main_loop()
             end_program();
         }
 
-        game::update(mv::app_state, input);
+        auto game_input = &input;
+
+        if (input::is_replaying(mv::replay))
+        {
+            if (!input::replay_input(mv::replay))
+            {
+                end_program();
+                continue;
+            }
+
+            game_input = &mv::replay.input;
+        }
+
+        input::record_frame(mv::recorder, *game_input);
+
+    #ifdef GAME_PUNK_PROFILE
+        if (input.keyboard.kbd_P.pressed)
+        {
+            game::profile::dump_trace("punk_run_trace.json");
+        }
+    #endif
+
+        game::update(mv::app_state, *game_input);
 
         window_render(input.window_size_changed);
 
@@ -252,9 +311,9 @@ static void main_loop()
 }
 
 
-int main()
+int main(int argc, char* argv[])
 {
-    if (!main_init())
+    if (!parse_args(argc, argv) || !main_init())
     {
         main_close();
         return mv::MAIN_ERROR;
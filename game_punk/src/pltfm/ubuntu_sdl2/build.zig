@@ -20,13 +20,14 @@ const cpp_flags = &[_][]const u8{
     "-DGAME_PUNK_RELEASE",
     "-DAPP_ROTATE_90",
     "-DIMAGE_READ",
+    "-DGAME_PUNK_DRAW_MT",
 };
 
 
 const cpp_libs = &[_][]const u8{
     "SDL2",
     "SDL2_mixer",
-    //"pthread",
+    "pthread",
     //"tbb"
 };
 
@@ -21,13 +21,14 @@ const cpp_flags = &[_][]const u8{
     "-DAPP_ROTATE_90",
     "-DIMAGE_READ",
     "-DNO_AUDIO",
+    "-DGAME_PUNK_DRAW_MT",
 };
 
 
 const cpp_libs = &[_][]const u8{
     "SDL3",
     "SDL3_mixer",
-    //"pthread",
+    "pthread",
     //"tbb"
 };
 
@@ -0,0 +1,518 @@
+#include "../../../libs/image/image.hpp"
+#include "../../../libs/datetime/datetime.hpp"
+#include "../../../libs/math/math_random.hpp"
+#include "../../res/xbin/bin_table.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace img = image;
+namespace dt = datetime;
+namespace bt = bin_table;
+
+using p32 = img::Pixel;
+
+
+// std::function kernels vs template kernels, ms per megapixel
+
+
+constexpr u32 WIDTH = 2048;
+constexpr u32 HEIGHT = 2048;
+constexpr u32 N_RUNS = 20;
+
+constexpr f64 MEGAPIXELS = (f64)(WIDTH * HEIGHT) / 1'000'000.0;
+
+
+/* memory */
+
+// image.cpp references the allocator, nothing here allocates through it
+namespace mem
+{
+    void* alloc_any(u32 n_elements, u32 element_size) { return std::malloc(n_elements * element_size); }
+
+    void free_any(void* ptr) { std::free(ptr); }
+
+    void* alloc_memory(u32 n_elements, u32 element_size) { return std::calloc(n_elements, element_size); }
+
+    void* alloc_memory(u32 n_elements, u32 element_size, cstr tag) { return std::calloc(n_elements, element_size); }
+
+    void free_memory(void* ptr, u32 element_size) { std::free(ptr); }
+
+    void add_memory(void* ptr, u32 n_elements, u32 element_size, cstr tag) {}
+
+    void tag_memory(void* ptr, u32 n_elements, u32 element_size, cstr tag) {}
+
+    void tag_file_memory(void* ptr, u32 element_size, cstr file_path) {}
+
+    void untag_memory(void* ptr, u32 element_size) {}
+
+    void* alloc_memory(u32 n_bytes, Alloc type) { return std::malloc(n_bytes); }
+
+    void* realloc_memory(void* ptr, u32 n_bytes, Alloc type) { return std::realloc(ptr, n_bytes); }
+
+    void free_memory(void* ptr, Alloc type) { std::free(ptr); }
+}
+
+
+/* kernels */
+
+namespace kernels
+{
+    static p32 invert(p32 p)
+    {
+        p.red = 255 - p.red;
+        p.green = 255 - p.green;
+        p.blue = 255 - p.blue;
+
+        return p;
+    }
+
+
+    static u8 to_gray(p32 p)
+    {
+        return (u8)((p.red * 77 + p.green * 150 + p.blue * 29) >> 8);
+    }
+
+
+    static p32 blend_mask(u8 mask, p32 p)
+    {
+        return mask ? img::to_pixel(255, 0, 0) : p;
+    }
+}
+
+
+/* SIMD vs scalar checks */
+
+namespace check
+{
+    // compiled SIMD path vs copy_if_alpha_span_scalar, returns spans that differ
+    static u32 copy_if_alpha_span();
+
+    // compiled fill_u32 and fill_f32 vs one Random32 per lane, returns fills that differ
+    static u32 random_fill();
+
+    // compiled bt::alpha_filter_convert with primary vs (s / 255) * primary, returns spans that differ
+    static u32 alpha_filter_convert();
+
+    // compiled bt::color_table_convert vs t[s], returns spans that differ
+    static u32 color_table_convert();
+}
+
+
+/* bench */
+
+namespace bench
+{
+    template <class RUN>
+    static f64 ms_per_mp(RUN const& run)
+    {
+        dt::Stopwatch sw;
+
+        run(); // warm up
+
+        sw.start();
+        for (u32 i = 0; i < N_RUNS; i++)
+        {
+            run();
+        }
+
+        return sw.get_time_milli_f64() / N_RUNS / MEGAPIXELS;
+    }
+
+
+    static void print(cstr name, f64 ms_fn, f64 ms_tmpl)
+    {
+        std::printf("%-22s %9.4f %9.4f %7.2fx\n", name, ms_fn, ms_tmpl, ms_fn / ms_tmpl);
+    }
+}
+
+
+int main()
+{
+    auto n_diff = check::copy_if_alpha_span();
+    std::printf("copy_if_alpha_span vs scalar, spans differ: %u\n", n_diff);
+    if (n_diff)
+    {
+        return 1;
+    }
+
+    n_diff = check::random_fill();
+    std::printf("Random32x8 fill vs scalar lanes, fills differ: %u\n", n_diff);
+    if (n_diff)
+    {
+        return 1;
+    }
+
+    n_diff = check::alpha_filter_convert();
+    std::printf("alpha_filter_convert vs scalar, spans differ: %u\n", n_diff);
+    if (n_diff)
+    {
+        return 1;
+    }
+
+    n_diff = check::color_table_convert();
+    std::printf("color_table_convert vs scalar, spans differ: %u\n", n_diff);
+    if (n_diff)
+    {
+        return 1;
+    }
+
+    auto n_pixels = WIDTH * HEIGHT;
+
+    auto src_data = (p32*)std::malloc(n_pixels * sizeof(p32));
+    auto dst_data = (p32*)std::malloc(n_pixels * sizeof(p32));
+    auto gray_data = (u8*)std::malloc(n_pixels);
+
+    if (!src_data || !dst_data || !gray_data)
+    {
+        return 1;
+    }
+
+    for (u32 i = 0; i < n_pixels; i++)
+    {
+        src_data[i].rgba = i * 2654435761u;
+        gray_data[i] = (u8)(i & 1);
+    }
+
+    auto src = img::make_view(src_data, WIDTH, HEIGHT);
+    auto dst = img::make_view(dst_data, WIDTH, HEIGHT);
+    auto gray = img::make_view(gray_data, WIDTH, HEIGHT);
+    auto dst_sub = img::sub_view(dst, img::make_rect(WIDTH, HEIGHT));
+    auto gray_sub = img::sub_view(gray, img::make_rect(WIDTH, HEIGHT));
+
+    u64 sum = 0;
+
+    auto const invert = [](p32 p){ return kernels::invert(p); };
+    auto const to_gray = [](p32 p){ return kernels::to_gray(p); };
+    auto const blend_mask = [](u8 m, p32 p){ return kernels::blend_mask(m, p); };
+    auto const accumulate = [&](p32 p){ sum += p.red; };
+    auto const xy_color = [](u32 x, u32 y){ return img::to_pixel((u8)x, (u8)y, 0); };
+
+    std::printf("%u x %u, %u runs\n", WIDTH, HEIGHT, N_RUNS);
+    std::printf("%-22s %9s %9s %8s\n", "ms/MP", "fn", "template", "speedup");
+
+    bench::print("transform rgba",
+        bench::ms_per_mp([&]{ img::transform(src, dst, fn<p32(p32)>(invert)); }),
+        bench::ms_per_mp([&]{ img::transform(src, dst, invert); }));
+
+    bench::print("transform rgba->gray",
+        bench::ms_per_mp([&]{ img::transform(src, gray, fn<u8(p32)>(to_gray)); }),
+        bench::ms_per_mp([&]{ img::transform(src, gray, to_gray); }));
+
+    bench::print("transform gray blend",
+        bench::ms_per_mp([&]{ img::transform(gray_sub, dst_sub, fn<p32(u8, p32)>(blend_mask)); }),
+        bench::ms_per_mp([&]{ img::transform(gray_sub, dst_sub, blend_mask); }));
+
+    bench::print("for_each_pixel",
+        bench::ms_per_mp([&]{ img::for_each_pixel(src, fn<void(p32)>(accumulate)); }),
+        bench::ms_per_mp([&]{ img::for_each_pixel(src, accumulate); }));
+
+    bench::print("for_each_xy",
+        bench::ms_per_mp([&]{ img::for_each_xy(dst, fn<p32(u32, u32)>(xy_color)); }),
+        bench::ms_per_mp([&]{ img::for_each_xy(dst, xy_color); }));
+
+    std::printf("checksum %llu %u\n", (unsigned long long)sum, dst_data[n_pixels / 2].rgba);
+
+    std::free(src_data);
+    std::free(dst_data);
+    std::free(gray_data);
+
+    return 0;
+}
+
+
+#include "../../../libs/image/image.cpp"
+#include "../../../libs/span/span.cpp"
+#include "../../../libs/math/math.cpp"
+#include "../../../libs/datetime/datetime.cpp"
+
+
+namespace check
+{
+    static u32 copy_if_alpha_span()
+    {
+        constexpr u32 MAX_LEN = 4099;
+        constexpr u32 MAX_OFFSET = 3;
+        constexpr u32 N = MAX_LEN + MAX_OFFSET;
+
+        p32 src[N];
+        p32 dst_simd[N];
+        p32 dst_scalar[N];
+
+        auto rng = math::make_random(1);
+
+        // alpha 0, 255 and in between
+        auto const random_pixel = [&]()
+        {
+            p32 p;
+            p.rgba = math::next_u32(rng);
+
+            switch (math::next_u32(rng, 0, 2))
+            {
+            case 0: p.alpha = 0; break;
+            case 1: p.alpha = 255; break;
+            default: p.alpha = (u8)math::next_u32(rng, 1, 254); break;
+            }
+
+            return p;
+        };
+
+        // every length up to 2 x 16 lanes, then odd and unaligned tails
+        u32 lengths[80] = { 0 };
+        u32 n_lengths = 0;
+
+        for (u32 len = 1; len <= 64; len++)
+        {
+            lengths[n_lengths++] = len;
+        }
+
+        constexpr u32 long_lengths[] = { 127, 129, 255, 257, 999, 1021, 1024, 2047, 4095, MAX_LEN };
+        for (auto len : long_lengths)
+        {
+            lengths[n_lengths++] = len;
+        }
+
+        u32 n_diff = 0;
+
+        for (u32 k = 0; k < n_lengths; k++)
+        {
+            auto len = lengths[k];
+
+            for (u32 offset = 0; offset <= MAX_OFFSET; offset++)
+            {
+                for (u32 i = 0; i < N; i++)
+                {
+                    src[i] = random_pixel();
+                    dst_simd[i] = random_pixel();
+                    dst_scalar[i] = dst_simd[i];
+                }
+
+                auto s = span::make_view(src + offset, len);
+                auto d = span::make_view(dst_simd + offset, len);
+
+                img::copy_if_alpha_span(s, d);
+                img::copy_if_alpha_span_scalar(src + offset, dst_scalar + offset, len);
+
+                n_diff += std::memcmp(dst_simd, dst_scalar, sizeof(dst_simd)) != 0;
+            }
+        }
+
+        return n_diff;
+    }
+
+
+    // lane i of fill_u32 is make_random(seed, stream * 8 + i), interleaved
+    static u32 random_fill()
+    {
+        constexpr u32 L = math::Random32x8::count;
+        constexpr u32 MAX_LEN = 1031;
+
+        u32 fill[MAX_LEN];
+        u32 ref[MAX_LEN];
+        f32 fill_f[MAX_LEN];
+        f32 ref_f[MAX_LEN];
+
+        constexpr u32 long_lengths[] = { 63, 64, 65, 127, 129, 255, 257, 1024, MAX_LEN };
+
+        u32 lengths[40 + sizeof(long_lengths) / sizeof(u32)] = { 0 };
+        u32 n_lengths = 0;
+
+        for (u32 len = 1; len <= 40; len++)
+        {
+            lengths[n_lengths++] = len;
+        }
+
+        for (auto len : long_lengths)
+        {
+            lengths[n_lengths++] = len;
+        }
+
+        u32 n_diff = 0;
+
+        for (u64 stream = 0; stream < 3; stream++)
+        {
+            for (u32 k = 0; k < n_lengths; k++)
+            {
+                auto len = lengths[k];
+                auto seed = 0x5EED0000 + k;
+
+                math::Random32 lanes[L];
+                for (u32 i = 0; i < L; i++)
+                {
+                    lanes[i] = math::make_random(seed, stream * L + i);
+                }
+
+                for (u32 i = 0; i < len; i++)
+                {
+                    ref[i] = math::next_u32(lanes[i % L]);
+                    ref_f[i] = (ref[i] >> 8) * (1.0f / (1u << 24));
+                }
+
+                auto rng = math::make_random_x8(seed, stream);
+                math::fill_u32(rng, fill, len);
+
+                auto rng_f = math::make_random_x8(seed, stream);
+                math::fill_f32(rng_f, fill_f, len);
+
+                n_diff += std::memcmp(fill, ref, len * sizeof(u32)) != 0;
+                n_diff += std::memcmp(fill_f, ref_f, len * sizeof(f32)) != 0;
+            }
+        }
+
+        return n_diff;
+    }
+
+
+    // every length up to 4 x 16 lanes, then odd and unaligned tails
+    static u32 convert_lengths(u32* lengths)
+    {
+        u32 n_lengths = 0;
+
+        for (u32 len = 1; len <= 64; len++)
+        {
+            lengths[n_lengths++] = len;
+        }
+
+        constexpr u32 long_lengths[] = { 127, 129, 255, 257, 999, 1021, 1024, 2047, 4095, 4099 };
+        for (auto len : long_lengths)
+        {
+            lengths[n_lengths++] = len;
+        }
+
+        return n_lengths;
+    }
+
+
+    static u32 alpha_filter_convert()
+    {
+        constexpr u32 MAX_LEN = 4099;
+        constexpr u32 MAX_OFFSET = 3;
+        constexpr u32 N = MAX_LEN + MAX_OFFSET;
+
+        u8 src[N];
+        p32 dst_simd[N];
+        p32 dst_scalar[N];
+
+        auto rng = math::make_random(2);
+
+        // filter values 0, 255 and in between
+        auto const random_filter = [&]()
+        {
+            switch (math::next_u32(rng, 0, 2))
+            {
+            case 0: return (u8)0;
+            case 1: return (u8)255;
+            default: return (u8)math::next_u32(rng, 1, 254);
+            }
+        };
+
+        u32 lengths[80] = { 0 };
+        auto n_lengths = convert_lengths(lengths);
+
+        u32 n_diff = 0;
+
+        for (u32 k = 0; k < n_lengths; k++)
+        {
+            auto len = lengths[k];
+
+            for (u32 offset = 0; offset <= MAX_OFFSET; offset++)
+            {
+                p32 primary;
+                primary.rgba = math::next_u32(rng);
+
+                for (u32 i = 0; i < N; i++)
+                {
+                    src[i] = random_filter();
+                    dst_simd[i].rgba = math::next_u32(rng);
+                    dst_scalar[i] = dst_simd[i];
+                }
+
+                auto s = span::make_view(src + offset, len);
+                auto d = span::make_view(dst_simd + offset, len);
+
+                bt::alpha_filter_convert(s, d, primary);
+
+                auto color = primary;
+                color.alpha = 255;
+
+                for (u32 i = offset; i < offset + len; i++)
+                {
+                    dst_scalar[i].rgba = (src[i] / 255) * color.rgba;
+                }
+
+                n_diff += std::memcmp(dst_simd, dst_scalar, sizeof(dst_simd)) != 0;
+            }
+        }
+
+        return n_diff;
+    }
+
+
+    static u32 color_table_convert()
+    {
+        constexpr u32 MAX_LEN = 4099;
+        constexpr u32 MAX_OFFSET = 3;
+        constexpr u32 N = MAX_LEN + MAX_OFFSET;
+
+        u8 src[N];
+        p32 table[256];
+        p32 dst_simd[N];
+        p32 dst_scalar[N];
+
+        auto rng = math::make_random(3);
+
+        u32 lengths[80] = { 0 };
+        auto n_lengths = convert_lengths(lengths);
+
+        u32 n_diff = 0;
+
+        for (u32 k = 0; k < n_lengths; k++)
+        {
+            auto len = lengths[k];
+
+            for (u32 offset = 0; offset <= MAX_OFFSET; offset++)
+            {
+                for (u32 i = 0; i < 256; i++)
+                {
+                    table[i].rgba = math::next_u32(rng);
+                }
+
+                for (u32 i = 0; i < N; i++)
+                {
+                    src[i] = (u8)math::next_u32(rng, 0, 255);
+                    dst_simd[i].rgba = math::next_u32(rng);
+                    dst_scalar[i] = dst_simd[i];
+                }
+
+                // one row, same as the manual views in gm_title
+                bt::TableFilterImage filter;
+                filter.gray.width = len;
+                filter.gray.height = 1;
+                filter.gray.data_ = src + offset;
+
+                bt::ColorTableImage color_table;
+                color_table.rgba.width = 256;
+                color_table.rgba.height = 1;
+                color_table.rgba.data_ = table;
+
+                auto dst = img::make_view(dst_simd + offset, len, 1);
+
+                if (!bt::color_table_convert(filter, color_table, dst))
+                {
+                    n_diff++;
+                    continue;
+                }
+
+                for (u32 i = offset; i < offset + len; i++)
+                {
+                    dst_scalar[i] = table[src[i]];
+                }
+
+                n_diff += std::memcmp(dst_simd, dst_scalar, sizeof(dst_simd)) != 0;
+            }
+        }
+
+        return n_diff;
+    }
+}
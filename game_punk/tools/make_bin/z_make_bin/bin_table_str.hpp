@@ -60,6 +60,9 @@ namespace xbin
         case FT::Image1C_AlphaFilter: return "FileType::Image1C_AlphaFilter";
         case FT::Image1C_TableFilter:  return "FileType::Image1C_TableFilter";
 
+        case FT::Image1C_IndexRaw: return "FileType::Image1C_IndexRaw";
+        case FT::Image1C_IndexRLE: return "FileType::Image1C_IndexRLE";
+
         case FT::Music: return "FileType::Music";
         case FT::SFX:   return "FileType::SFX";
 
@@ -68,6 +71,13 @@ namespace xbin
     }
 
 
+    // items keep the set type unless stored with their own encoding
+    static cstr item_type(bin::FileInfo_Image const& item)
+    {
+        return item.type == bin::FileType::Unknown ? "file_type" : to_cstr(item.type);
+    }
+
+
     std::string define_image_set(bin::Info_ImageX const& info, cstr set_class, bin::FileType image_type)
     {
         auto& set_name = info.name;
@@ -92,7 +102,7 @@ namespace xbin
                 auto offset = (int)item.offset;
                 auto size = (int)item.size;
 
-                    xbin::oss_tab(oss, t) << "to_image_info(file_type, " << w << ", " << h << ", ";
+                    xbin::oss_tab(oss, t) << "to_image_info(" << xbin::item_type(item) << ", " << w << ", " << h << ", ";
                     oss << name << ", " << offset << ", " << size << "),\n";
             }
             t--;
@@ -215,7 +225,7 @@ namespace xbin
                 auto offset = (int)item.offset;
                 auto size = (int)item.size;
 
-                    xbin::oss_tab(oss, t) << "to_image_info(file_type, " << w << ", " << h << ", ";
+                    xbin::oss_tab(oss, t) << "to_image_info(" << xbin::item_type(item) << ", " << w << ", " << h << ", ";
                     oss << name << ", " << offset << ", " << size << "),\n";
             }
             t--;
@@ -366,7 +376,7 @@ namespace xbin
                 auto offset = (int)item.offset;
                 auto size = (int)item.size;
 
-                    xbin::oss_tab(oss, t) << "to_image_info(file_type, " << w << ", " << h << ", ";
+                    xbin::oss_tab(oss, t) << "to_image_info(" << xbin::item_type(item) << ", " << w << ", " << h << ", ";
                     oss << name << ", " << offset << ", " << size << "),\n";
             }
             t--;
@@ -18,6 +18,125 @@ namespace bin
     constexpr u32 GIGA = 1024 * MEGA;  
 
 
+    enum class ImageEncoding : u8
+    {
+        File,       // image file bytes (png)
+        IndexPlane  // 1 channel, raw or rle
+    };
+
+
+    // set to ImageEncoding::File for png compressed filters
+    constexpr auto FILTER_ENCODING = ImageEncoding::IndexPlane;
+
+
+    static void encode_index_rle(SpanView<u8> const& src, std::vector<u8>& dst)
+    {
+        using namespace bin_table;
+
+        auto s = src.data;
+        auto length = src.length;
+
+        u32 lit_begin = 0;
+        u32 lit_count = 0;
+
+        auto flush_literals = [&]()
+        {
+            if (!lit_count)
+            {
+                return;
+            }
+
+            dst.push_back((u8)(lit_count - 1));
+            dst.insert(dst.end(), s + lit_begin, s + lit_begin + lit_count);
+            lit_count = 0;
+        };
+
+        u32 i = 0;
+        while (i < length)
+        {
+            u32 run = 1;
+            while (i + run < length && run < RLE_MAX_RUN && s[i + run] == s[i])
+            {
+                run++;
+            }
+
+            if (run >= RLE_MIN_RUN)
+            {
+                flush_literals();
+                dst.push_back((u8)(RLE_RUN + run - RLE_MIN_RUN));
+                dst.push_back(s[i]);
+                i += run;
+                continue;
+            }
+
+            if (!lit_count)
+            {
+                lit_begin = i;
+            }
+
+            lit_count++;
+            i++;
+
+            if (lit_count == RLE_MAX_LITERAL)
+            {
+                flush_literals();
+            }
+        }
+
+        flush_literals();
+    }
+
+
+    static u32 write_index_plane(FileInfo_Image& item, std::ofstream& bin_file)
+    {
+        img::ImageGray gray;
+        if (!img::read_image_from_file(item.path.string().c_str(), gray))
+        {
+            return 0;
+        }
+
+        auto length = gray.width * gray.height;
+        auto raw = span::make_view(gray.data_, length);
+
+        std::vector<u8> rle;
+        encode_index_rle(raw, rle);
+
+        if (rle.size() < length)
+        {
+            item.type = FileType::Image1C_IndexRLE;
+            item.size = (u32)rle.size();
+            bin_file.write((char*)rle.data(), rle.size());
+        }
+        else
+        {
+            item.type = FileType::Image1C_IndexRaw;
+            item.size = length;
+            bin_file.write((char*)raw.data, length);
+        }
+
+        img::destroy_image(gray);
+
+        return item.size;
+    }
+
+
+    static u32 write_image_file(FileInfo_Image& item, std::ofstream& bin_file)
+    {
+        auto buffer = fs::read_bytes(item.path.string().c_str());
+        if (!buffer.ok)
+        {                
+            return 0;
+        }
+
+        item.size = buffer.size_;
+
+        util::write_buffer(buffer, bin_file);
+        mb::destroy_buffer(buffer);
+
+        return item.size;
+    }
+
+
     u32 load_image_file(u32 offset, sfs::path const& path, FileInfo_Image& info, std::ofstream& bin_file)
     {
         img::Image image;
@@ -48,7 +167,7 @@ namespace bin
     }
     
     
-    u32 load_directory(u32 offset, sfs::path const& dir, InfoList_Image& list, std::ofstream& bin_file)
+    u32 load_directory(u32 offset, sfs::path const& dir, InfoList_Image& list, std::ofstream& bin_file, ImageEncoding encoding = ImageEncoding::File)
     {
         list.offset = offset;
 
@@ -97,20 +216,19 @@ namespace bin
         
         for (auto& item : items)
         {
-            auto buffer = fs::read_bytes(item.path.string().c_str());
-            if (!buffer.ok)
-            {                
+            auto size = encoding == ImageEncoding::IndexPlane 
+                ? write_index_plane(item, bin_file) 
+                : write_image_file(item, bin_file);
+
+            if (!size)
+            {
                 continue;
             }
 
-            item.size = buffer.size_;
             item.offset = item_offset;
 
             item_offset += item.size;
             list.size += item.size;
-
-            util::write_buffer(buffer, bin_file);
-            mb::destroy_buffer(buffer);
         }
 
         return item_offset - list.offset; // list.size
@@ -140,7 +258,7 @@ namespace bin
         info.size += size;
         offset += size;
 
-        size = load_directory(offset, ov_dir, overlay.list, bin_file);
+        size = load_directory(offset, ov_dir, overlay.list, bin_file, FILTER_ENCODING);
         overlay.size = size;
         overlay.offset = offset;
         info.size += size;
@@ -177,7 +295,7 @@ namespace bin
             info.size = 0;
             info.name = dir.filename();
 
-            size = load_directory(offset, dir, info.list, bin_file);
+            size = load_directory(offset, dir, info.list, bin_file, FILTER_ENCODING);
             info.size += size;
             offset += size;
 
@@ -206,7 +324,7 @@ namespace bin
             auto dir_files = dir / "sprites";
             auto path_table = dir / "table.png";
 
-            auto size = load_directory(offset, dir_files, info.list, bin_file);
+            auto size = load_directory(offset, dir_files, info.list, bin_file, FILTER_ENCODING);
             info.size += size;
             offset += size;
 
@@ -235,7 +353,7 @@ namespace bin
             auto dir_files = dir / "tiles";
             auto path_table = dir / "table.png";
 
-            auto size = load_directory(offset, dir_files, info.list, bin_file);
+            auto size = load_directory(offset, dir_files, info.list, bin_file, FILTER_ENCODING);
             info.size += size;
             offset += size;
 
@@ -267,7 +385,7 @@ namespace bin
             auto dir_files = dir / "images";
             auto path_table = dir / "table.png";
 
-            auto size = load_directory(offset, dir_files, info.list, bin_file);
+            auto size = load_directory(offset, dir_files, info.list, bin_file, FILTER_ENCODING);
             info.size += size;
             offset += size;
 
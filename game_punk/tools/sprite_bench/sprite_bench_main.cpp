@@ -0,0 +1,364 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define app_assert(...)
+#define app_log(...)
+#define app_crash(...)
+
+#include "../../../libs/io/filesystem.hpp"
+#include "../../../libs/datetime/datetime.hpp"
+
+#include "../../src/app/app.cpp"
+
+
+namespace game = game_punk;
+namespace dt = datetime;
+
+
+// per sprite function pointers vs (name, mode) groups + SIMD integration, ms per frame
+
+
+constexpr u32 N_SPRITES = 16'384;
+constexpr u32 N_FRAMES = 600;
+
+// sprites changing mode every frame
+constexpr u32 N_MODE_CHANGES = 32;
+
+
+/* memory */
+
+// no allocation tracking, libs/alloc_type counts are SDL only
+namespace mem
+{
+    void* alloc_any(u32 n_elements, u32 element_size) { return std::malloc(n_elements * element_size); }
+
+    void free_any(void* ptr) { std::free(ptr); }
+
+    void* alloc_memory(u32 n_elements, u32 element_size) { return std::calloc(n_elements, element_size); }
+
+    void* alloc_memory(u32 n_elements, u32 element_size, cstr tag) { return std::calloc(n_elements, element_size); }
+
+    void free_memory(void* ptr, u32 element_size) { std::free(ptr); }
+
+    void add_memory(void* ptr, u32 n_elements, u32 element_size, cstr tag) {}
+
+    void tag_memory(void* ptr, u32 n_elements, u32 element_size, cstr tag) {}
+
+    void tag_file_memory(void* ptr, u32 element_size, cstr file_path) {}
+
+    void untag_memory(void* ptr, u32 element_size) {}
+
+    void* alloc_memory(u32 n_bytes, Alloc type) { return std::malloc(n_bytes); }
+
+    void* realloc_memory(void* ptr, u32 n_bytes, Alloc type) { return std::realloc(ptr, n_bytes); }
+
+    void free_memory(void* ptr, Alloc type) { std::free(ptr); }
+}
+
+
+/* filesystem */
+
+// no assets are loaded
+namespace fs
+{
+    u32 file_size(cstr file_path) { return 0; }
+
+    MemoryBuffer<u8> read_bytes(cstr file_path) { MemoryBuffer<u8> b; b.ok = 0; return b; }
+
+    void select_image_file(SingleFileResult* result) {}
+
+    MemoryBuffer<u8> map_bytes(cstr file_path) { MemoryBuffer<u8> b; b.ok = 0; return b; }
+
+    void unmap_bytes(MemoryBuffer<u8>& buffer) {}
+}
+
+
+/* per sprite reference */
+
+// the update loop before sprites were grouped
+namespace ref
+{
+    using namespace game_punk;
+
+
+    static AccelerateFn get_accelerate_x_fn(SpriteMode mode)
+    {
+        switch (mode)
+        {
+        case SpriteMode::Idle: return accelerate_punk_idle_x;
+        case SpriteMode::Run: return accelerate_punk_run_x;
+
+        default: return accelerate_zero;
+        }
+    }
+
+
+    static AccelerateFn get_accelerate_y_fn(SpriteMode mode)
+    {
+        switch (mode)
+        {
+        case SpriteMode::Jump: return accelerate_punk_jump_y;
+
+        default: return accelerate_zero;
+        }
+    }
+
+
+    class SpriteArrays
+    {
+    public:
+        GameTick64* mode_begin = 0;
+
+        AccelerateFn* accelerate_x = 0;
+        AccelerateFn* accelerate_y = 0;
+
+        TileAcc* acceleration_x = 0;
+        TileAcc* acceleration_y = 0;
+
+        TileSpeed* speed_x = 0;
+        TileSpeed* speed_y = 0;
+
+        TileDim* position_x = 0;
+        TileDim* position_y = 0;
+    };
+
+
+    template <typename T>
+    static T* alloc(u32 n) { return (T*)std::calloc(n, sizeof(T)); }
+
+
+    static void create(SpriteArrays& s, u32 n)
+    {
+        s.mode_begin = alloc<GameTick64>(n);
+        s.accelerate_x = alloc<AccelerateFn>(n);
+        s.accelerate_y = alloc<AccelerateFn>(n);
+        s.acceleration_x = alloc<TileAcc>(n);
+        s.acceleration_y = alloc<TileAcc>(n);
+        s.speed_x = alloc<TileSpeed>(n);
+        s.speed_y = alloc<TileSpeed>(n);
+        s.position_x = alloc<TileDim>(n);
+        s.position_y = alloc<TileDim>(n);
+    }
+
+
+    static void destroy(SpriteArrays& s)
+    {
+        std::free(s.mode_begin);
+        std::free(s.accelerate_x);
+        std::free(s.accelerate_y);
+        std::free(s.acceleration_x);
+        std::free(s.acceleration_y);
+        std::free(s.speed_x);
+        std::free(s.speed_y);
+        std::free(s.position_x);
+        std::free(s.position_y);
+    }
+
+
+    static void set_mode(SpriteArrays& s, u32 i, SpriteMode mode, GameTick64 tick)
+    {
+        s.mode_begin[i] = tick;
+        s.accelerate_x[i] = get_accelerate_x_fn(mode);
+        s.accelerate_y[i] = get_accelerate_y_fn(mode);
+    }
+
+
+    static void move_sprites_xy(SpriteArrays const& s, u32 N, GameTick64 tick)
+    {
+        auto beg = s.mode_begin;
+
+        auto accfn_x = s.accelerate_x;
+        auto accfn_y = s.accelerate_y;
+
+        auto acc_x = s.acceleration_x;
+        auto vel_x = s.speed_x;
+        auto pos_x = s.position_x;
+
+        auto acc_y = s.acceleration_y;
+        auto vel_y = s.speed_y;
+        auto pos_y = s.position_y;
+
+        for (u32 i = 0; i < N; i++)
+        {
+            auto time = tick - beg[i];
+
+            acc_x[i] = accfn_x[i](vel_x[i], time);
+            acc_y[i] = accfn_y[i](vel_y[i], time);
+
+            vel_x[i] += acc_x[i];
+            vel_y[i] += acc_y[i];
+
+            pos_x[i] += vel_x[i];
+            pos_y[i] += vel_y[i];
+        }
+    }
+}
+
+
+/* scenario */
+
+namespace scenario
+{
+    using namespace game_punk;
+
+
+    static u32 next(Random32& rng, u32 max)
+    {
+        return math::next_u32(rng, 0, max - 1);
+    }
+
+
+    static SpriteMode random_mode(Random32& rng)
+    {
+        return (SpriteMode)next(rng, (u32)SpriteMode::Count);
+    }
+
+
+    static SpriteDef make_def(Random32& rng, u32 k)
+    {
+        auto x = TileDim::make(TileValue::make((i32)next(rng, 1000)));
+        auto y = TileDim::make(TileValue::make((i32)next(rng, 100)));
+        auto bmp = BitmapID{};
+
+        SpriteDef def(GameTick64::make(k % 60), { x, y }, bmp, SpriteName::Punk, random_mode(rng));
+
+        def.velocity.x = speed_px((f32)next(rng, 200) / 100.0f);
+        def.velocity.y = speed_px((f32)next(rng, 200) / 100.0f - 1.0f);
+
+        return def;
+    }
+
+
+    static u32 frame_tick(u32 f) { return 60 + f; }
+}
+
+
+/* bench */
+
+namespace bench
+{
+    using namespace game_punk;
+
+
+    template <class RUN>
+    static f64 ms_per_frame(RUN const& run)
+    {
+        dt::Stopwatch sw;
+
+        sw.start();
+        for (u32 f = 0; f < N_FRAMES; f++)
+        {
+            run(f);
+        }
+
+        return sw.get_time_milli_f64() / N_FRAMES;
+    }
+
+
+    static bool same(TileDim a, TileDim b)
+    {
+        return std::memcmp(&a, &b, sizeof(TileDim)) == 0;
+    }
+}
+
+
+int main()
+{
+    using namespace game_punk;
+
+    MemoryCounts counts{};
+
+    SpriteTable table;
+    count_table(table, counts, N_SPRITES);
+
+    auto memory = create_memory(counts);
+    if (!memory.ok || !create_table(table, memory))
+    {
+        return 1;
+    }
+
+    reset_sprite_table(table);
+
+    ref::SpriteArrays arrays;
+    ref::create(arrays, N_SPRITES);
+
+    auto ids = (SpriteID*)std::malloc(N_SPRITES * sizeof(SpriteID));
+    if (!ids || !arrays.position_y)
+    {
+        return 1;
+    }
+
+    auto rng = math::make_random(12345);
+
+    for (u32 k = 0; k < N_SPRITES; k++)
+    {
+        auto def = scenario::make_def(rng, k);
+
+        ids[k] = spawn_sprite(table, def);
+
+        ref::set_mode(arrays, k, def.mode, def.mode_begin);
+        arrays.speed_x[k] = def.velocity.x;
+        arrays.speed_y[k] = def.velocity.y;
+        arrays.position_x[k] = def.position.x;
+        arrays.position_y[k] = def.position.y;
+    }
+
+    auto rng_ref = math::make_random(12345, 1);
+    auto rng_grouped = rng_ref;
+
+    auto const run_ref = [&](u32 f)
+    {
+        auto tick = GameTick64::make(scenario::frame_tick(f));
+
+        for (u32 c = 0; c < N_MODE_CHANGES; c++)
+        {
+            auto k = scenario::next(rng_ref, N_SPRITES);
+            ref::set_mode(arrays, k, scenario::random_mode(rng_ref), tick);
+        }
+
+        ref::move_sprites_xy(arrays, N_SPRITES, tick);
+    };
+
+    auto const run_grouped = [&](u32 f)
+    {
+        auto tick = GameTick64::make(scenario::frame_tick(f));
+
+        for (u32 c = 0; c < N_MODE_CHANGES; c++)
+        {
+            auto k = scenario::next(rng_grouped, N_SPRITES);
+            set_sprite_mode(table, ids[k], scenario::random_mode(rng_grouped), tick);
+        }
+
+        move_sprites_xy(table, tick);
+    };
+
+    auto ms_ref = bench::ms_per_frame(run_ref);
+    auto ms_grouped = bench::ms_per_frame(run_grouped);
+
+    u32 n_diff = 0;
+    for (u32 k = 0; k < N_SPRITES; k++)
+    {
+        auto pos = table.get_tile_pos(ids[k]);
+        n_diff += !bench::same(pos.x, arrays.position_x[k]);
+        n_diff += !bench::same(pos.y, arrays.position_y[k]);
+    }
+
+    std::printf("%u sprites, %u frames, %u mode changes per frame\n", N_SPRITES, N_FRAMES, N_MODE_CHANGES);
+    std::printf("%-22s %9s %9s %8s\n", "ms/frame", "per sprite", "grouped", "speedup");
+    std::printf("%-22s %9.4f %9.4f %7.2fx\n", "move_sprites_xy", ms_ref, ms_grouped, ms_ref / ms_grouped);
+    std::printf("positions differ: %u\n", n_diff);
+
+    std::free(ids);
+    ref::destroy(arrays);
+    destroy_memory(memory);
+
+    return n_diff ? 1 : 0;
+}
+
+
+#include "../../../libs/span/span.cpp"
+#include "../../../libs/image/image.cpp"
+#include "../../../libs/stb_libs/stb_libs.cpp"
+#include "../../../libs/math/math.cpp"
+#include "../../../libs/datetime/datetime.cpp"
@@ -2,6 +2,7 @@
 
 #include "image.hpp"
 #include "../math/math.hpp"
+#include "../math/math_intrin.hpp"
 
 #include "../stb_libs/stb_image_options.hpp"
 
@@ -299,6 +300,218 @@ namespace image
 }
 
 
+/* copy_if_alpha span */
+
+namespace image
+{
+    static inline void copy_if_alpha_span_scalar(Pixel* src, Pixel* dst, u32 len)
+    {
+        Pixel ps;
+        Pixel pd;
+
+        for (u32 i = 0; i < len; i++)
+        {
+            ps = src[i];
+            pd = dst[i];
+            dst[i] = ps.alpha ? ps : pd;
+        }
+    }
+
+
+#if defined(MATH_SIMD_256)
+
+    static inline void copy_if_alpha_span(SpanView<Pixel> const& src, SpanView<Pixel> const& dst)
+    {
+        constexpr u32 N = 8;
+
+        auto const alpha_mask = _mm256_set1_epi32((int)0xFF000000);
+        auto const zero = _mm256_setzero_si256();
+
+        auto s = src.data;
+        auto d = dst.data;
+
+        u32 len = dst.length / N * N;
+        u32 i = 0;
+
+        for (; i < len; i += N)
+        {
+            auto vs = _mm256_loadu_si256((__m256i*)(s + i));
+            auto vd = _mm256_loadu_si256((__m256i*)(d + i));
+
+            // lanes with zero alpha keep dst
+            auto off = _mm256_cmpeq_epi32(_mm256_and_si256(vs, alpha_mask), zero);
+
+            _mm256_storeu_si256((__m256i*)(d + i), _mm256_blendv_epi8(vs, vd, off));
+        }
+
+        copy_if_alpha_span_scalar(s + i, d + i, dst.length - i);
+    }
+
+#elif defined(MATH_SIMD_WASM_128)
+
+    static inline void copy_if_alpha_span(SpanView<Pixel> const& src, SpanView<Pixel> const& dst)
+    {
+        constexpr u32 N = 4;
+
+        auto const alpha_mask = wasm_i32x4_splat((int)0xFF000000);
+        auto const zero = wasm_i32x4_splat(0);
+
+        auto s = src.data;
+        auto d = dst.data;
+
+        u32 len = dst.length / N * N;
+        u32 i = 0;
+
+        for (; i < len; i += N)
+        {
+            auto vs = wasm_v128_load(s + i);
+            auto vd = wasm_v128_load(d + i);
+
+            auto off = wasm_i32x4_eq(wasm_v128_and(vs, alpha_mask), zero);
+
+            wasm_v128_store(d + i, wasm_v128_bitselect(vd, vs, off));
+        }
+
+        copy_if_alpha_span_scalar(s + i, d + i, dst.length - i);
+    }
+
+#elif defined(MATH_SIMD_SSE2)
+
+    static inline void copy_if_alpha_span(SpanView<Pixel> const& src, SpanView<Pixel> const& dst)
+    {
+        constexpr u32 N = 4;
+
+        auto const alpha_mask = _mm_set1_epi32((int)0xFF000000);
+        auto const zero = _mm_setzero_si128();
+
+        auto s = src.data;
+        auto d = dst.data;
+
+        u32 len = dst.length / N * N;
+        u32 i = 0;
+
+        for (; i < len; i += N)
+        {
+            auto vs = _mm_loadu_si128((__m128i*)(s + i));
+            auto vd = _mm_loadu_si128((__m128i*)(d + i));
+
+            auto off = _mm_cmpeq_epi32(_mm_and_si128(vs, alpha_mask), zero);
+
+            _mm_storeu_si128((__m128i*)(d + i), _mm_or_si128(_mm_and_si128(off, vd), _mm_andnot_si128(off, vs)));
+        }
+
+        copy_if_alpha_span_scalar(s + i, d + i, dst.length - i);
+    }
+
+#else
+
+    static inline void copy_if_alpha_span(SpanView<Pixel> const& src, SpanView<Pixel> const& dst)
+    {
+        copy_if_alpha_span_scalar(src.data, dst.data, dst.length);
+    }
+
+#endif
+}
+
+
+/* copy_palette span */
+
+namespace image
+{
+    static inline void copy_palette_span_scalar(u8* src, Pixel* dst, Pixel const* palette, u32 len)
+    {
+        for (u32 i = 0; i < len; i++)
+        {
+            dst[i] = palette[src[i]];
+        }
+    }
+
+
+    static inline void copy_palette_if_alpha_span_scalar(u8* src, Pixel* dst, Pixel const* palette, u32 len)
+    {
+        Pixel ps;
+        Pixel pd;
+
+        for (u32 i = 0; i < len; i++)
+        {
+            ps = palette[src[i]];
+            pd = dst[i];
+            dst[i] = ps.alpha ? ps : pd;
+        }
+    }
+
+
+#if defined(MATH_SIMD_256)
+
+    static inline void copy_palette_span(SpanView<u8> const& src, SpanView<Pixel> const& dst, Pixel const* palette)
+    {
+        constexpr u32 N = 8;
+
+        auto p = (int const*)palette;
+        auto s = src.data;
+        auto d = dst.data;
+
+        u32 len = dst.length / N * N;
+        u32 i = 0;
+
+        for (; i < len; i += N)
+        {
+            auto id = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i*)(s + i)));
+
+            _mm256_storeu_si256((__m256i*)(d + i), _mm256_i32gather_epi32(p, id, 4));
+        }
+
+        copy_palette_span_scalar(s + i, d + i, palette, dst.length - i);
+    }
+
+
+    static inline void copy_palette_if_alpha_span(SpanView<u8> const& src, SpanView<Pixel> const& dst, Pixel const* palette)
+    {
+        constexpr u32 N = 8;
+
+        auto const alpha_mask = _mm256_set1_epi32((int)0xFF000000);
+        auto const zero = _mm256_setzero_si256();
+
+        auto p = (int const*)palette;
+        auto s = src.data;
+        auto d = dst.data;
+
+        u32 len = dst.length / N * N;
+        u32 i = 0;
+
+        for (; i < len; i += N)
+        {
+            auto id = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i*)(s + i)));
+
+            auto vs = _mm256_i32gather_epi32(p, id, 4);
+            auto vd = _mm256_loadu_si256((__m256i*)(d + i));
+
+            auto off = _mm256_cmpeq_epi32(_mm256_and_si256(vs, alpha_mask), zero);
+
+            _mm256_storeu_si256((__m256i*)(d + i), _mm256_blendv_epi8(vs, vd, off));
+        }
+
+        copy_palette_if_alpha_span_scalar(s + i, d + i, palette, dst.length - i);
+    }
+
+#else
+
+    // no gather below AVX2
+    static inline void copy_palette_span(SpanView<u8> const& src, SpanView<Pixel> const& dst, Pixel const* palette)
+    {
+        copy_palette_span_scalar(src.data, dst.data, palette, dst.length);
+    }
+
+
+    static inline void copy_palette_if_alpha_span(SpanView<u8> const& src, SpanView<Pixel> const& dst, Pixel const* palette)
+    {
+        copy_palette_if_alpha_span_scalar(src.data, dst.data, palette, dst.length);
+    }
+
+#endif
+}
+
+
 /* fill */
 
 namespace image
@@ -555,42 +768,50 @@ namespace image
         assert(dst.width == src.width);
         assert(dst.height == src.height);
 
-        auto s = to_span(src);
-        auto d = to_span(dst);
+        copy_if_alpha_span(to_span(src), to_span(dst));
+    }
 
-        Pixel ps;
-        Pixel pd;
 
-        for (u32 i = 0; i < s.length; i++)
+    void copy_if_alpha(SubView const& src, SubView const& dst)
+    {
+        assert(src.matrix_data_);
+        assert(dst.matrix_data_);
+        assert(dst.width == src.width);
+        assert(dst.height == src.height);
+
+        for (u32 y = 0; y < src.height; y++)
         {
-            ps = s.data[i];
-            pd = d.data[i];
-            d.data[i] = ps.alpha ? ps : pd;
+            copy_if_alpha_span(row_span(src, y), row_span(dst, y));
         }
     }
 
 
-    void copy_if_alpha(SubView const& src, SubView const& dst)
+    void copy_palette(GraySubView const& src, SubView const& dst, Pixel const* palette)
     {
         assert(src.matrix_data_);
         assert(dst.matrix_data_);
+        assert(palette);
         assert(dst.width == src.width);
         assert(dst.height == src.height);
 
-        Pixel ps;
-        Pixel pd;
-
         for (u32 y = 0; y < src.height; y++)
         {
-            auto s = row_span(src, y);
-            auto d = row_span(dst, y);
+            copy_palette_span(row_span(src, y), row_span(dst, y), palette);
+        }
+    }
 
-            for (u32 i = 0; i < s.length; i++)
-            {
-                ps = s.data[i];
-                pd = d.data[i];
-                d.data[i] = ps.alpha ? ps : pd;
-            }
+
+    void copy_palette_if_alpha(GraySubView const& src, SubView const& dst, Pixel const* palette)
+    {
+        assert(src.matrix_data_);
+        assert(dst.matrix_data_);
+        assert(palette);
+        assert(dst.width == src.width);
+        assert(dst.height == src.height);
+
+        for (u32 y = 0; y < src.height; y++)
+        {
+            copy_palette_if_alpha_span(row_span(src, y), row_span(dst, y), palette);
         }
     }
 }
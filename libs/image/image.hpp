@@ -482,6 +482,11 @@ namespace image
     void copy_if_alpha(ImageView const& src, ImageView const& dst);
 
     void copy_if_alpha(SubView const& src, SubView const& dst);
+
+
+    void copy_palette(GraySubView const& src, SubView const& dst, Pixel const* palette);
+
+    void copy_palette_if_alpha(GraySubView const& src, SubView const& dst, Pixel const* palette);
 }
 
 
@@ -565,6 +570,239 @@ namespace image
 }
 
 
+/* inline kernels */
+
+// Template overloads of for_each/transform/fill_if.
+// The callable is a template parameter so it can be inlined and the loops vectorized.
+// Lambdas bind here; std::function arguments still use the compiled versions above.
+
+#include <type_traits>
+
+namespace image
+{
+namespace kernel
+{
+    template <typename S, typename D, class FUNC>
+    inline void transform_span(S const* s, D* d, u32 length, FUNC const& func)
+    {
+        if constexpr (std::is_invocable_v<FUNC const&, S, D>)
+        {
+            for (u32 i = 0; i < length; i++)
+            {
+                d[i] = func(s[i], d[i]);
+            }
+        }
+        else
+        {
+            for (u32 i = 0; i < length; i++)
+            {
+                d[i] = func(s[i]);
+            }
+        }
+    }
+
+
+    template <class V_SRC, class V_DST, class FUNC>
+    inline void transform_view(V_SRC const& src, V_DST const& dst, FUNC const& func)
+    {
+        assert(src.matrix_data_);
+        assert(dst.matrix_data_);
+        assert(dst.width == src.width);
+        assert(dst.height == src.height);
+
+        transform_span(src.matrix_data_, dst.matrix_data_, src.width * src.height, func);
+    }
+
+
+    template <class V_SRC, class V_DST, class FUNC>
+    inline void transform_rows(V_SRC const& src, V_DST const& dst, FUNC const& func)
+    {
+        assert(src.matrix_data_);
+        assert(dst.matrix_data_);
+        assert(dst.width == src.width);
+        assert(dst.height == src.height);
+
+        for (u32 y = 0; y < src.height; y++)
+        {
+            transform_span(row_begin(src, y), row_begin(dst, y), src.width, func);
+        }
+    }
+
+
+    template <typename T, class FUNC>
+    inline void for_each_span(T const* s, u32 length, FUNC const& func)
+    {
+        for (u32 i = 0; i < length; i++)
+        {
+            func(s[i]);
+        }
+    }
+
+
+    template <class VIEW, class FUNC>
+    inline void for_each_xy(VIEW const& view, FUNC const& xy_func)
+    {
+        assert(view.matrix_data_);
+        assert(view.width);
+        assert(view.height);
+
+        for (u32 y = 0; y < view.height; y++)
+        {
+            if constexpr (std::is_void_v<std::invoke_result_t<FUNC const&, u32, u32>>)
+            {
+                for (u32 x = 0; x < view.width; x++)
+                {
+                    xy_func(x, y);
+                }
+            }
+            else
+            {
+                auto d = row_begin(view, y);
+                for (u32 x = 0; x < view.width; x++)
+                {
+                    d[x] = xy_func(x, y);
+                }
+            }
+        }
+    }
+
+
+    template <class V_SRC, class V_DST, class FUNC>
+    inline void transform_scale_up(V_SRC const& src, V_DST const& dst, u32 scale, FUNC const& func)
+    {
+        assert(src.matrix_data_);
+        assert(dst.matrix_data_);
+        assert(dst.width == src.width * scale);
+        assert(dst.height == src.height * scale);
+
+        using S = std::remove_cv_t<std::remove_pointer_t<decltype(src.matrix_data_)>>;
+        using D = std::remove_cv_t<std::remove_pointer_t<decltype(dst.matrix_data_)>>;
+
+        constexpr auto is_blend = std::is_invocable_v<FUNC const&, S, D>;
+
+        for (u32 src_y = 0; src_y < src.height; src_y++)
+        {
+            auto s = row_begin(src, src_y);
+
+            for (u32 offset_y = 0; offset_y < scale; offset_y++)
+            {
+                auto d = row_begin(dst, src_y * scale + offset_y);
+
+                for (u32 src_x = 0; src_x < src.width; src_x++)
+                {
+                    auto dx = d + src_x * scale;
+
+                    if constexpr (is_blend)
+                    {
+                        for (u32 offset_x = 0; offset_x < scale; offset_x++)
+                        {
+                            dx[offset_x] = func(s[src_x], dx[offset_x]);
+                        }
+                    }
+                    else
+                    {
+                        auto const value = func(s[src_x]);
+                        for (u32 offset_x = 0; offset_x < scale; offset_x++)
+                        {
+                            dx[offset_x] = value;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+}
+
+
+namespace image
+{
+    template <class FUNC>
+    inline void for_each_pixel(ImageView const& view, FUNC const& func)
+    {
+        assert(view.matrix_data_);
+
+        kernel::for_each_span(view.matrix_data_, view.width * view.height, func);
+    }
+
+
+    template <class FUNC>
+    inline void for_each_pixel(SubView const& view, FUNC const& func)
+    {
+        assert(view.matrix_data_);
+
+        for (u32 y = 0; y < view.height; y++)
+        {
+            kernel::for_each_span(row_begin(view, y), view.width, func);
+        }
+    }
+
+
+    template <class FUNC>
+    inline void for_each_xy(ImageView const& view, FUNC const& xy_func) { kernel::for_each_xy(view, xy_func); }
+
+    template <class FUNC>
+    inline void for_each_xy(SubView const& view, FUNC const& xy_func) { kernel::for_each_xy(view, xy_func); }
+
+    template <class FUNC>
+    inline void for_each_xy(GrayView const& view, FUNC const& xy_func) { kernel::for_each_xy(view, xy_func); }
+
+
+    template <class FUNC>
+    inline void fill_if(GraySubView const& view, u8 gray, FUNC const& pred)
+    {
+        assert(view.matrix_data_);
+
+        for (u32 y = 0; y < view.height; y++)
+        {
+            auto d = row_begin(view, y);
+            for (u32 x = 0; x < view.width; x++)
+            {
+                d[x] = pred(d[x]) ? gray : d[x];
+            }
+        }
+    }
+
+
+    template <class FUNC>
+    inline void transform(ImageView const& src, ImageView const& dst, FUNC const& func) { kernel::transform_view(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(SubView const& src, ImageView const& dst, FUNC const& func) { kernel::transform_rows(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(ImageView const& src, SubView const& dst, FUNC const& func) { kernel::transform_rows(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(SubView const& src, SubView const& dst, FUNC const& func) { kernel::transform_rows(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(GrayView const& src, SubView const& dst, FUNC const& func) { kernel::transform_rows(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(GraySubView const& src, SubView const& dst, FUNC const& func) { kernel::transform_rows(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(ImageView const& src, GrayView const& dst, FUNC const& func) { kernel::transform_view(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(ImageView const& src, GraySubView const& dst, FUNC const& func) { kernel::transform_rows(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(GrayView const& src, ImageView const& dst, FUNC const& func) { kernel::transform_view(src, dst, func); }
+
+    template <class FUNC>
+    inline void transform(GraySubView const& src, ImageView const& dst, FUNC const& func) { kernel::transform_rows(src, dst, func); }
+
+
+    template <class FUNC>
+    inline void transform_scale_up(GraySubView const& src, SubView const& dst, u32 scale, FUNC const& func) { kernel::transform_scale_up(src, dst, scale, func); }
+
+    template <class FUNC>
+    inline void transform_scale_up(ImageView const& src, GrayView const& dst, u32 scale, FUNC const& func) { kernel::transform_scale_up(src, dst, scale, func); }
+}
+
+
 /* circle */
 
 namespace image
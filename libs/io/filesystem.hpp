@@ -97,6 +97,13 @@ namespace fs
     MemoryBuffer<u8> read_bytes(cstr path);
 
     void select_image_file(SingleFileResult* result);
+
+
+    // read-only file mapping, not ok when unsupported (WASM)
+    // release with unmap_bytes(), not mem::free()
+    MemoryBuffer<u8> map_bytes(cstr path);
+
+    void unmap_bytes(MemoryBuffer<u8>& buffer);
 }
 
 
@@ -109,6 +116,10 @@ namespace fs
     MemoryBuffer<u8> read_bytes(cstr path) { MemoryBuffer<u8> b; return b; }
 
     void select_image_file(SingleFileResult* result) {}
+
+    MemoryBuffer<u8> map_bytes(cstr path) { MemoryBuffer<u8> b; return b; }
+
+    void unmap_bytes(MemoryBuffer<u8>& buffer) {}
 }
 
 
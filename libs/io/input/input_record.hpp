@@ -0,0 +1,270 @@
+#pragma once
+
+#include "input.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+
+/* definitions */
+
+namespace input
+{
+	// file: header, then one delta per frame
+	// frame: u16 n_runs, n_runs * { u16 offset, u16 length, u8 bytes[length] }
+
+	constexpr u32 RECORD_MAGIC = 0x524B5050; // "PPKR"
+	constexpr u32 RECORD_VERSION = 1;
+
+	constexpr u32 RECORD_INPUT_SIZE = (u32)sizeof(Input);
+
+	static_assert(RECORD_INPUT_SIZE < 0xFFFF);
+
+
+	class RecordHeader
+	{
+	public:
+		u32 magic = RECORD_MAGIC;
+		u32 version = RECORD_VERSION;
+		u32 input_size = RECORD_INPUT_SIZE;
+		u32 reserved = 0;
+	};
+
+
+	class InputRecorder
+	{
+	public:
+		std::FILE* file = 0;
+
+		Input last;
+
+		u32 n_frames = 0;
+
+		// worst case delta is smaller than 2 * input size
+		u8 frame_data[2 * RECORD_INPUT_SIZE + 2];
+	};
+
+
+	class InputReplay
+	{
+	public:
+		std::FILE* file = 0;
+
+		Input input;
+
+		u32 n_frames = 0;
+
+		b8 is_done = 1;
+	};
+}
+
+
+/* record */
+
+namespace input
+{
+	inline bool is_recording(InputRecorder const& rec)
+	{
+		return rec.file;
+	}
+
+
+	inline void end_record(InputRecorder& rec)
+	{
+		if (rec.file)
+		{
+			std::fclose(rec.file);
+			rec.file = 0;
+		}
+	}
+
+
+	inline bool begin_record(InputRecorder& rec, cstr file_path)
+	{
+		end_record(rec);
+
+		rec.file = std::fopen(file_path, "wb");
+		if (!rec.file)
+		{
+			return false;
+		}
+
+		RecordHeader header{};
+		if (std::fwrite(&header, sizeof(header), 1, rec.file) != 1)
+		{
+			end_record(rec);
+			return false;
+		}
+
+		std::memset((void*)&rec.last, 0, RECORD_INPUT_SIZE);
+		rec.n_frames = 0;
+
+		return true;
+	}
+
+
+	inline void record_frame(InputRecorder& rec, Input const& input)
+	{
+		// merge runs separated by fewer bytes than a run header
+		constexpr u32 min_gap = 2 * sizeof(u16);
+
+		if (!rec.file)
+		{
+			return;
+		}
+
+		auto src = (u8 const*)&input;
+		auto last = (u8*)&rec.last;
+		auto out = rec.frame_data + sizeof(u16);
+
+		u16 n_runs = 0;
+		u32 i = 0;
+
+		while (i < RECORD_INPUT_SIZE)
+		{
+			if (src[i] == last[i])
+			{
+				++i;
+				continue;
+			}
+
+			auto begin = i;
+			auto end = i + 1;
+			u32 gap = 0;
+
+			for (i = end; i < RECORD_INPUT_SIZE && gap < min_gap; i++)
+			{
+				if (src[i] == last[i])
+				{
+					++gap;
+				}
+				else
+				{
+					gap = 0;
+					end = i + 1;
+				}
+			}
+
+			u16 offset = (u16)begin;
+			u16 length = (u16)(end - begin);
+
+			std::memcpy(out, &offset, sizeof(u16));
+			std::memcpy(out + sizeof(u16), &length, sizeof(u16));
+			std::memcpy(out + 2 * sizeof(u16), src + begin, length);
+			std::memcpy(last + begin, src + begin, length);
+
+			out += 2 * sizeof(u16) + length;
+			++n_runs;
+
+			i = end;
+		}
+
+		std::memcpy(rec.frame_data, &n_runs, sizeof(u16));
+
+		auto n_bytes = (u32)(out - rec.frame_data);
+		if (std::fwrite(rec.frame_data, 1, n_bytes, rec.file) != n_bytes)
+		{
+			end_record(rec);
+			return;
+		}
+
+		++rec.n_frames;
+	}
+}
+
+
+/* replay */
+
+namespace input
+{
+	inline bool is_replaying(InputReplay const& rp)
+	{
+		return rp.file && !rp.is_done;
+	}
+
+
+	inline void end_replay(InputReplay& rp)
+	{
+		if (rp.file)
+		{
+			std::fclose(rp.file);
+			rp.file = 0;
+		}
+
+		rp.is_done = 1;
+	}
+
+
+	inline bool begin_replay(InputReplay& rp, cstr file_path)
+	{
+		end_replay(rp);
+
+		rp.file = std::fopen(file_path, "rb");
+		if (!rp.file)
+		{
+			return false;
+		}
+
+		RecordHeader header{};
+		RecordHeader expected{};
+
+		auto ok = std::fread(&header, sizeof(header), 1, rp.file) == 1;
+		ok &= header.magic == expected.magic;
+		ok &= header.version == expected.version;
+		ok &= header.input_size == expected.input_size;
+
+		if (!ok)
+		{
+			end_replay(rp);
+			return false;
+		}
+
+		std::memset((void*)&rp.input, 0, RECORD_INPUT_SIZE);
+		rp.n_frames = 0;
+		rp.is_done = 0;
+
+		return true;
+	}
+
+
+	// stands in for record_input(), returns false when the recording is finished
+	inline bool replay_input(InputReplay& rp)
+	{
+		if (!is_replaying(rp))
+		{
+			return false;
+		}
+
+		auto dst = (u8*)&rp.input;
+
+		u16 n_runs = 0;
+		if (std::fread(&n_runs, sizeof(u16), 1, rp.file) != 1)
+		{
+			end_replay(rp);
+			return false;
+		}
+
+		for (u32 r = 0; r < n_runs; r++)
+		{
+			u16 run[2] = { 0 };
+
+			auto ok = std::fread(run, sizeof(u16), 2, rp.file) == 2;
+
+			auto offset = run[0];
+			auto length = run[1];
+
+			ok &= (u32)offset + length <= RECORD_INPUT_SIZE;
+			ok &= ok && std::fread(dst + offset, 1, length, rp.file) == length;
+
+			if (!ok)
+			{
+				end_replay(rp);
+				return false;
+			}
+		}
+
+		++rp.n_frames;
+
+		return true;
+	}
+}
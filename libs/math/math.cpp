@@ -552,21 +552,3 @@ namespace math
 
     f64 atan2(f64 sin, f64 cos) { return std::atan2(sin, cos); }
 }
-
-
-/* random */
-
-namespace math
-{
-    void rand_init()
-    {
-        std::srand(1);
-    }
-
-
-    f32 rand(f32 min, f32 max)
-    {
-        auto r = (f32)std::rand() / (f32)RAND_MAX;
-        return min + r * (max - min);
-    }
-}
\ No newline at end of file
@@ -289,13 +289,3 @@ namespace math
         return cxpr::rad_to_unsigned<uangle>(rad);
     }
 }
-
-
-/* random */
-
-namespace math
-{
-    void rand_init();
-
-    f32 rand(f32 min, f32 max);
-}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "math_intrin.hpp"
+
+#include <cstring>
+
+
+/* lane hash */
+
+namespace math
+{
+    // 8 u32 lanes over 32 byte stripes, same result for scalar and SIMD
+    // not for hash tables or security, for comparing runs and builds
+    class Hash32x8
+    {
+    public:
+        static constexpr u32 count = 8;
+        static constexpr u32 stripe_bytes = count * sizeof(u32);
+
+        alignas(32) u32 acc[count] = { 0 };
+    };
+
+
+    constexpr u32 HASH_PRIME_1 = 0x9E3779B1;
+    constexpr u32 HASH_PRIME_2 = 0x85EBCA77;
+
+
+    inline void hash_begin(Hash32x8& h, u64 seed)
+    {
+        auto lo = (u32)seed;
+        auto hi = (u32)(seed >> 32);
+
+        for (u32 i = 0; i < h.count; i++)
+        {
+            h.acc[i] = (lo + HASH_PRIME_1 * (i + 1)) ^ hi;
+        }
+    }
+
+
+    inline constexpr u32 hash_round(u32 acc, u32 word)
+    {
+        acc += word * HASH_PRIME_2;
+        acc = (acc << 13) | (acc >> 19);
+
+        return acc * HASH_PRIME_1;
+    }
+
+
+    inline void hash_stripes_scalar(Hash32x8& h, u8 const* data, u32 n_stripes)
+    {
+        constexpr u32 N = Hash32x8::count;
+
+        for (u32 s = 0; s < n_stripes; s++)
+        {
+            u32 words[N];
+            std::memcpy(words, data + s * h.stripe_bytes, h.stripe_bytes);
+
+            for (u32 i = 0; i < N; i++)
+            {
+                h.acc[i] = hash_round(h.acc[i], words[i]);
+            }
+        }
+    }
+
+
+#if defined(MATH_SIMD_256)
+
+    inline void hash_stripes(Hash32x8& h, u8 const* data, u32 n_stripes)
+    {
+        auto p1 = _mm256_set1_epi32((int)HASH_PRIME_1);
+        auto p2 = _mm256_set1_epi32((int)HASH_PRIME_2);
+
+        auto acc = _mm256_load_si256((__m256i*)h.acc);
+
+        for (u32 s = 0; s < n_stripes; s++)
+        {
+            auto w = _mm256_loadu_si256((__m256i*)(data + s * h.stripe_bytes));
+
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(w, p2));
+            acc = _mm256_or_si256(_mm256_slli_epi32(acc, 13), _mm256_srli_epi32(acc, 19));
+            acc = _mm256_mullo_epi32(acc, p1);
+        }
+
+        _mm256_store_si256((__m256i*)h.acc, acc);
+    }
+
+#elif defined(MATH_SIMD_SSE2)
+
+    // no _mm_mullo_epi32 before SSE4.1
+    inline __m128i hash_mullo_x4(__m128i a, __m128i b)
+    {
+        auto even = _mm_mul_epu32(a, b);
+        auto odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+        return _mm_unpacklo_epi32(
+            _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+
+    inline void hash_stripes(Hash32x8& h, u8 const* data, u32 n_stripes)
+    {
+        auto p1 = _mm_set1_epi32((int)HASH_PRIME_1);
+        auto p2 = _mm_set1_epi32((int)HASH_PRIME_2);
+
+        // two independent halves of 4 lanes
+        for (u32 k = 0; k < h.count; k += 4)
+        {
+            auto acc = _mm_load_si128((__m128i*)(h.acc + k));
+
+            for (u32 s = 0; s < n_stripes; s++)
+            {
+                auto w = _mm_loadu_si128((__m128i*)(data + s * h.stripe_bytes + k * sizeof(u32)));
+
+                acc = _mm_add_epi32(acc, hash_mullo_x4(w, p2));
+                acc = _mm_or_si128(_mm_slli_epi32(acc, 13), _mm_srli_epi32(acc, 19));
+                acc = hash_mullo_x4(acc, p1);
+            }
+
+            _mm_store_si128((__m128i*)(h.acc + k), acc);
+        }
+    }
+
+#else
+
+    inline void hash_stripes(Hash32x8& h, u8 const* data, u32 n_stripes)
+    {
+        hash_stripes_scalar(h, data, n_stripes);
+    }
+
+#endif
+
+
+    inline u64 hash_end(Hash32x8 const& h, u64 n_bytes)
+    {
+        u64 x = n_bytes;
+
+        for (u32 i = 0; i < h.count; i++)
+        {
+            x = (x ^ h.acc[i]) * 0x9E3779B97F4A7C15;
+            x ^= x >> 32;
+        }
+
+        x ^= x >> 29;
+        x *= 0xBF58476D1CE4E5B9;
+        x ^= x >> 32;
+
+        return x;
+    }
+
+
+    // chain calls through seed to hash several arrays
+    inline u64 hash_bytes(void const* data, u32 n_bytes, u64 seed = 0)
+    {
+        constexpr u32 S = Hash32x8::stripe_bytes;
+
+        Hash32x8 h;
+        hash_begin(h, seed);
+
+        auto bytes = (u8 const*)data;
+        auto n_stripes = n_bytes / S;
+
+        hash_stripes(h, bytes, n_stripes);
+
+        auto n_tail = n_bytes - n_stripes * S;
+        if (n_tail)
+        {
+            // zero padded, the length is mixed in at the end
+            u8 tail[S] = { 0 };
+            std::memcpy(tail, bytes + n_stripes * S, n_tail);
+            hash_stripes(h, tail, 1);
+        }
+
+        return hash_end(h, n_bytes);
+    }
+}
@@ -6,6 +6,26 @@
 #define MATH_USE_SIMD
 #endif
 
+
+#ifdef MATH_USE_SIMD
+
+#ifdef __AVX2__
+#define MATH_SIMD_256
+#endif
+
+#ifdef __SSE2__
+#define MATH_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef __wasm_simd128__
+#define MATH_SIMD_WASM_128
+// -msimd128
+#include <wasm_simd128.h>
+#endif
+
+#endif // MATH_USE_SIMD
+
 //#define __AVX__
 
 #ifdef MATH_USE_SIMD
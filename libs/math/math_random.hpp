@@ -0,0 +1,321 @@
+#pragma once
+
+#include "math_intrin.hpp"
+
+
+/* splitmix64 */
+
+namespace math
+{
+    // seeds generator state, consecutive outputs are well mixed even for seeds 0, 1, 2...
+    inline constexpr u64 splitmix64(u64& x)
+    {
+        x += 0x9E3779B97F4A7C15;
+
+        u64 z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+
+        return z ^ (z >> 31);
+    }
+
+
+    // one seed, many independent sequences
+    inline constexpr u64 stream_seed(u64 seed, u64 stream)
+    {
+        u64 x = stream;
+        return seed ^ splitmix64(x);
+    }
+}
+
+
+/* xoshiro128** */
+
+namespace math
+{
+    class Random32
+    {
+    public:
+        u32 s[4] = { 0 };
+    };
+
+
+    inline constexpr u32 rotl32(u32 x, u32 k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+
+    inline constexpr Random32 make_random(u64 seed, u64 stream = 0)
+    {
+        Random32 rng;
+
+        u64 x = stream_seed(seed, stream);
+        u64 a = splitmix64(x);
+        u64 b = splitmix64(x);
+
+        rng.s[0] = (u32)a;
+        rng.s[1] = (u32)(a >> 32);
+        rng.s[2] = (u32)b;
+        rng.s[3] = (u32)(b >> 32);
+
+        return rng;
+    }
+
+
+    inline constexpr u32 next_u32(Random32& rng)
+    {
+        auto& s = rng.s;
+
+        u32 result = rotl32(s[1] * 5, 7) * 9;
+        u32 t = s[1] << 9;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl32(s[3], 11);
+
+        return result;
+    }
+
+
+    // [min, max]
+    inline constexpr u32 next_u32(Random32& rng, u32 min, u32 max)
+    {
+        u64 range = (u64)max - min + 1;
+
+        return min + (u32)((next_u32(rng) * range) >> 32);
+    }
+
+
+    // [0, 1)
+    inline constexpr f32 next_f32(Random32& rng)
+    {
+        return (next_u32(rng) >> 8) * (1.0f / (1u << 24));
+    }
+
+
+    inline constexpr f32 next_f32(Random32& rng, f32 min, f32 max)
+    {
+        return min + next_f32(rng) * (max - min);
+    }
+}
+
+
+/* xoshiro128** x8 */
+
+namespace math
+{
+    // 8 interleaved generators for bulk fills, lane i is make_random(seed, stream * 8 + i)
+    class Random32x8
+    {
+    public:
+        static constexpr u32 count = 8;
+
+        alignas(32) u32 s0[count] = { 0 };
+        alignas(32) u32 s1[count] = { 0 };
+        alignas(32) u32 s2[count] = { 0 };
+        alignas(32) u32 s3[count] = { 0 };
+    };
+
+
+    inline Random32x8 make_random_x8(u64 seed, u64 stream = 0)
+    {
+        Random32x8 rng;
+
+        for (u32 i = 0; i < rng.count; i++)
+        {
+            auto lane = make_random(seed, stream * rng.count + i);
+            rng.s0[i] = lane.s[0];
+            rng.s1[i] = lane.s[1];
+            rng.s2[i] = lane.s[2];
+            rng.s3[i] = lane.s[3];
+        }
+
+        return rng;
+    }
+
+
+    inline void next_u32_x8_scalar(Random32x8& rng, u32* dst)
+    {
+        for (u32 i = 0; i < rng.count; i++)
+        {
+            Random32 lane;
+            lane.s[0] = rng.s0[i];
+            lane.s[1] = rng.s1[i];
+            lane.s[2] = rng.s2[i];
+            lane.s[3] = rng.s3[i];
+
+            dst[i] = next_u32(lane);
+
+            rng.s0[i] = lane.s[0];
+            rng.s1[i] = lane.s[1];
+            rng.s2[i] = lane.s[2];
+            rng.s3[i] = lane.s[3];
+        }
+    }
+
+
+#if defined(MATH_SIMD_256)
+
+    inline __m256i rotl32_x8(__m256i x, int k)
+    {
+        return _mm256_or_si256(_mm256_slli_epi32(x, k), _mm256_srli_epi32(x, 32 - k));
+    }
+
+
+    inline void fill_u32(Random32x8& rng, u32* dst, u32 len)
+    {
+        constexpr u32 N = Random32x8::count;
+
+        auto s0 = _mm256_load_si256((__m256i*)rng.s0);
+        auto s1 = _mm256_load_si256((__m256i*)rng.s1);
+        auto s2 = _mm256_load_si256((__m256i*)rng.s2);
+        auto s3 = _mm256_load_si256((__m256i*)rng.s3);
+
+        u32 len8 = len / N * N;
+        u32 i = 0;
+
+        for (; i < len8; i += N)
+        {
+            // * 5 and * 9 as shift and add
+            auto x5 = _mm256_add_epi32(_mm256_slli_epi32(s1, 2), s1);
+            auto r = rotl32_x8(x5, 7);
+            r = _mm256_add_epi32(_mm256_slli_epi32(r, 3), r);
+
+            auto t = _mm256_slli_epi32(s1, 9);
+
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = rotl32_x8(s3, 11);
+
+            _mm256_storeu_si256((__m256i*)(dst + i), r);
+        }
+
+        _mm256_store_si256((__m256i*)rng.s0, s0);
+        _mm256_store_si256((__m256i*)rng.s1, s1);
+        _mm256_store_si256((__m256i*)rng.s2, s2);
+        _mm256_store_si256((__m256i*)rng.s3, s3);
+
+        if (i < len)
+        {
+            u32 tail[N];
+            next_u32_x8_scalar(rng, tail);
+
+            for (u32 j = 0; i < len; i++, j++)
+            {
+                dst[i] = tail[j];
+            }
+        }
+    }
+
+#elif defined(MATH_SIMD_SSE2)
+
+    inline __m128i rotl32_x4(__m128i x, int k)
+    {
+        return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k));
+    }
+
+
+    inline void fill_u32(Random32x8& rng, u32* dst, u32 len)
+    {
+        constexpr u32 N = Random32x8::count;
+
+        u32 len8 = len / N * N;
+
+        // two independent halves of 4 lanes
+        for (u32 h = 0; h < N; h += 4)
+        {
+            auto s0 = _mm_load_si128((__m128i*)(rng.s0 + h));
+            auto s1 = _mm_load_si128((__m128i*)(rng.s1 + h));
+            auto s2 = _mm_load_si128((__m128i*)(rng.s2 + h));
+            auto s3 = _mm_load_si128((__m128i*)(rng.s3 + h));
+
+            for (u32 i = 0; i < len8; i += N)
+            {
+                auto x5 = _mm_add_epi32(_mm_slli_epi32(s1, 2), s1);
+                auto r = rotl32_x4(x5, 7);
+                r = _mm_add_epi32(_mm_slli_epi32(r, 3), r);
+
+                auto t = _mm_slli_epi32(s1, 9);
+
+                s2 = _mm_xor_si128(s2, s0);
+                s3 = _mm_xor_si128(s3, s1);
+                s1 = _mm_xor_si128(s1, s2);
+                s0 = _mm_xor_si128(s0, s3);
+                s2 = _mm_xor_si128(s2, t);
+                s3 = rotl32_x4(s3, 11);
+
+                _mm_storeu_si128((__m128i*)(dst + i + h), r);
+            }
+
+            _mm_store_si128((__m128i*)(rng.s0 + h), s0);
+            _mm_store_si128((__m128i*)(rng.s1 + h), s1);
+            _mm_store_si128((__m128i*)(rng.s2 + h), s2);
+            _mm_store_si128((__m128i*)(rng.s3 + h), s3);
+        }
+
+        if (len8 < len)
+        {
+            u32 tail[N];
+            next_u32_x8_scalar(rng, tail);
+
+            for (u32 i = len8, j = 0; i < len; i++, j++)
+            {
+                dst[i] = tail[j];
+            }
+        }
+    }
+
+#else
+
+    inline void fill_u32(Random32x8& rng, u32* dst, u32 len)
+    {
+        constexpr u32 N = Random32x8::count;
+
+        u32 i = 0;
+        for (; i + N <= len; i += N)
+        {
+            next_u32_x8_scalar(rng, dst + i);
+        }
+
+        if (i < len)
+        {
+            u32 tail[N];
+            next_u32_x8_scalar(rng, tail);
+
+            for (u32 j = 0; i < len; i++, j++)
+            {
+                dst[i] = tail[j];
+            }
+        }
+    }
+
+#endif
+
+
+    // [0, 1)
+    inline void fill_f32(Random32x8& rng, f32* dst, u32 len)
+    {
+        constexpr u32 N = 64;
+
+        u32 bits[N];
+
+        for (u32 i = 0; i < len; i += N)
+        {
+            auto n = len - i < N ? len - i : N;
+
+            fill_u32(rng, bits, n);
+
+            for (u32 j = 0; j < n; j++)
+            {
+                dst[i + j] = (bits[j] >> 8) * (1.0f / (1u << 24));
+            }
+        }
+    }
+}
@@ -88,4 +88,126 @@ namespace fs
         fs_assert("select_image_file() no implemented" && false);
     }
 
+}
+
+/* memory map */
+
+#if defined(_WIN32)
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+#elif !defined(__EMSCRIPTEN__)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif
+
+
+namespace fs
+{
+    MemoryBuffer<u8> map_bytes(cstr file_path)
+    {
+        MemoryBuffer<u8> buffer;
+        buffer.ok = 0;
+
+    #if defined(_WIN32)
+
+        auto file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return buffer;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || !size.QuadPart || size.QuadPart > 0xFFFFFFFF)
+        {
+            CloseHandle(file);
+            return buffer;
+        }
+
+        auto mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+        CloseHandle(file);
+        if (!mapping)
+        {
+            return buffer;
+        }
+
+        // view keeps the mapping alive
+        auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!data)
+        {
+            fs_log("MapViewOfFile() error (%s)", file_path);
+            return buffer;
+        }
+
+        buffer.data_ = (u8*)data;
+        buffer.capacity_ = (u32)size.QuadPart;
+
+    #elif !defined(__EMSCRIPTEN__)
+
+        auto fd = ::open(file_path, O_RDONLY);
+        if (fd < 0)
+        {
+            return buffer;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) || st.st_size <= 0 || (u64)st.st_size > 0xFFFFFFFF)
+        {
+            ::close(fd);
+            return buffer;
+        }
+
+        auto size = (u32)st.st_size;
+        auto data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            fs_log("mmap() error (%s)", file_path);
+            return buffer;
+        }
+
+        buffer.data_ = (u8*)data;
+        buffer.capacity_ = size;
+
+    #else
+
+        return buffer;
+
+    #endif
+
+        buffer.size_ = buffer.capacity_;
+        buffer.ok = 1;
+
+        return buffer;
+    }
+
+
+    void unmap_bytes(MemoryBuffer<u8>& buffer)
+    {
+        if (buffer.data_)
+        {
+        #if defined(_WIN32)
+            UnmapViewOfFile(buffer.data_);
+        #elif !defined(__EMSCRIPTEN__)
+            munmap(buffer.data_, buffer.capacity_);
+        #endif
+        }
+
+        buffer.data_ = nullptr;
+        buffer.capacity_ = 0;
+        buffer.size_ = 0;
+        buffer.ok = 0;
+    }
 }
\ No newline at end of file
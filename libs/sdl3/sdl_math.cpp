@@ -216,20 +216,3 @@ namespace math
 
     f64 atan2(f64 sin, f64 cos) { return SDL_atan2(sin, cos); }
 }
-
-
-/* random */
-
-namespace math
-{
-    void rand_init()
-    {
-        SDL_srand(1);
-    }
-
-
-    f32 rand(f32 min, f32 max)
-    {
-        return min + SDL_randf() * (max - min);
-    }
-}
\ No newline at end of file